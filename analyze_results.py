@@ -103,15 +103,23 @@ def analyze_transfer_curves(csv_path):
 
     df = pd.read_csv(csv_path)
 
+    # One curve per run and channel: the rising/falling rows split the same samples by slope
+    if 'direction' in df.columns:
+        df = df[df['direction'] == 'all']
+    if 'channel' not in df.columns:
+        df = df.assign(channel='L')
+    channels = list(df['channel'].unique())
+
     print(f"\nTotal measurements: {len(df)}")
     print(f"Unique runs: {df['runId'].nunique()}")
-    print(f"Bins per run: ~{len(df) / df['runId'].nunique():.0f}")
+    print(f"Channels: {', '.join(str(c) for c in channels)}")
+    print(f"Bins per run and channel: ~{len(df) / (df['runId'].nunique() * len(channels)):.0f}")
 
-    # Statistics by input gain
+    # Statistics by channel and input gain
     print("\n--- Transfer Curve Statistics by Input Gain ---")
-    for gain in sorted(df['inputGainDb'].unique()):
-        gain_data = df[df['inputGainDb'] == gain]
-        print(f"\nInput Gain: {gain} dB")
+    for channel, gain in sorted(df.groupby(['channel', 'inputGainDb']).groups.keys()):
+        gain_data = df[(df['channel'] == channel) & (df['inputGainDb'] == gain)]
+        print(f"\nChannel {channel}, Input Gain: {gain} dB")
         print(f"  Input range (x): [{gain_data['x'].min():.6f}, {gain_data['x'].max():.6f}]")
         print(f"  Output range (meanY): [{gain_data['meanY'].min():.6f}, {gain_data['meanY'].max():.6f}]")
         print(f"  Linear region check:")
@@ -134,8 +142,8 @@ def analyze_transfer_curves(csv_path):
 
     # Analyze linearity
     print("\n--- Linearity Analysis ---")
-    for gain in sorted(df['inputGainDb'].unique()):
-        gain_data = df[df['inputGainDb'] == gain].copy()
+    for channel, gain in sorted(df.groupby(['channel', 'inputGainDb']).groups.keys()):
+        gain_data = df[(df['channel'] == channel) & (df['inputGainDb'] == gain)].copy()
         gain_data = gain_data.sort_values('x')
 
         # Calculate deviation from linear
@@ -148,7 +156,7 @@ def analyze_transfer_curves(csv_path):
             residuals = y_vals - y_pred
             rmse = np.sqrt(np.mean(residuals**2))
 
-            print(f"\nInput Gain {gain} dB:")
+            print(f"\nChannel {channel}, Input Gain {gain} dB:")
             print(f"  Linear fit: y = {coeffs[0]:.6f}*x + {coeffs[1]:.6f}")
             print(f"  RMSE from linear: {rmse:.6f}")
             print(f"  Max deviation: {np.abs(residuals).max():.6f}")
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Analyzer.h"
+#include "JuceHeader.h"
+#include <algorithm>
+#include <memory>
+#include <tuple>
+
+// Statically dispatched composition of sample-streaming analyzers.
+// A stage provides
+//   void beginBlock(const BlockContext& ctx);                  // per-run lookup, once per block
+//   void processSamples(const BlockContext& ctx, int start, int numSamples);
+//   void endBlock(const BlockContext& ctx);
+//   void finish(const juce::File& outDir);
+// and its own processBlock() is the single-stage version of the same sequence, so each analyzer still works
+// on its own through the virtual Analyzer interface. The pipeline walks the block in chunks small enough to
+// stay in L1 and hands every chunk to all stages in turn, so the block is fetched from memory once no
+// matter how many stages run, and the calls between stages are resolved at compile time. A null stage (an
+// analyzer that is not configured) is skipped, so one pipeline type covers every subset of its stages.
+template <typename... Stages>
+struct AnalyzerPipeline : public Analyzer {
+    static constexpr int chunkSize = 64;
+
+    explicit AnalyzerPipeline(std::unique_ptr<Stages>... stages) : stages(std::move(stages)...) {}
+
+    void processBlock(const BlockContext& ctx) override {
+        std::apply([&](auto&... stage) { ((stage ? stage->beginBlock(ctx) : void()), ...); }, stages);
+
+        for (int start = 0; start < ctx.numSamples; start += chunkSize) {
+            const int numSamples = std::min(chunkSize, ctx.numSamples - start);
+            std::apply([&](auto&... stage) { ((stage ? stage->processSamples(ctx, start, numSamples) : void()), ...); },
+                       stages);
+        }
+
+        std::apply([&](auto&... stage) { ((stage ? stage->endBlock(ctx) : void()), ...); }, stages);
+    }
+
+    void finish(const juce::File& outDir) override {
+        std::apply([&](auto&... stage) { ((stage ? stage->finish(outDir) : void()), ...); }, stages);
+    }
+
+private:
+    std::tuple<std::unique_ptr<Stages>...> stages;
+};
+
+template <typename... Stages>
+std::unique_ptr<Analyzer> createAnalyzerPipeline(std::unique_ptr<Stages>... stages) {
+    return std::make_unique<AnalyzerPipeline<Stages...>>(std::move(stages)...);
+}
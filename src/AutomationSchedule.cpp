@@ -0,0 +1,84 @@
+#include "AutomationSchedule.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+AutomationSchedule::AutomationSchedule(const std::vector<AutomationEventConfig>& eventConfigs, double sampleRate,
+                                       int rampStepSamples)
+    : rampStepSamples(std::max(1, rampStepSamples)) {
+    for (const auto& eventConfig : eventConfigs) {
+        // Parameters are matched case-insensitively, as in ParameterIndex
+        const juce::String name = eventConfig.paramName.trim();
+        int param = 0;
+        while (param < (int)parameterNames.size() && !parameterNames[param].equalsIgnoreCase(name))
+            ++param;
+        if (param == (int)parameterNames.size())
+            parameterNames.push_back(name);
+
+        Event event;
+        event.param = param;
+        event.startSample = (int64_t)std::llround(std::max(0.0, eventConfig.timeSeconds) * sampleRate);
+        event.endSample =
+            event.startSample + (int64_t)std::llround(std::max(0.0, eventConfig.rampSeconds) * sampleRate);
+        event.target = juce::jlimit(0.0f, 1.0f, eventConfig.value);
+        events.push_back(event);
+    }
+
+    // Events starting together keep their configured order, so the later one wins
+    std::stable_sort(events.begin(), events.end(),
+                     [](const Event& a, const Event& b) { return a.startSample < b.startSample; });
+
+    values.assign(parameterNames.size(), 0.0f);
+    startValues.assign(events.size(), 0.0f);
+    started.assign(events.size(), false);
+}
+
+void AutomationSchedule::reset(const std::vector<float>& initialValues) {
+    for (size_t i = 0; i < values.size(); ++i)
+        values[i] = i < initialValues.size() ? initialValues[i] : 0.0f;
+    std::fill(started.begin(), started.end(), false);
+}
+
+int64_t AutomationSchedule::nextChange(int64_t position) const {
+    int64_t next = std::numeric_limits<int64_t>::max();
+    for (const auto& event : events) {
+        if (event.startSample > position) {
+            // Later events start later still
+            next = std::min(next, event.startSample);
+            break;
+        }
+        if (position < event.endSample) {
+            const int64_t step = ((position - event.startSample) / rampStepSamples + 1) * rampStepSamples;
+            next = std::min(next, std::min(event.startSample + step, event.endSample));
+        }
+    }
+    return next;
+}
+
+void AutomationSchedule::update(int64_t position, std::vector<int>& changed) {
+    changed.clear();
+
+    previousValues = values;
+    for (size_t e = 0; e < events.size(); ++e) {
+        const auto& event = events[e];
+        if (event.startSample > position)
+            break;
+
+        if (!started[e]) {
+            startValues[e] = values[event.param];
+            started[e] = true;
+        }
+
+        float value = event.target;
+        if (position < event.endSample) {
+            const float t = (float)(position - event.startSample) / (float)(event.endSample - event.startSample);
+            value = startValues[e] + (event.target - startValues[e]) * t;
+        }
+        values[event.param] = value;
+    }
+
+    for (int p = 0; p < (int)values.size(); ++p) {
+        if (values[p] != previousValues[p])
+            changed.push_back(p);
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Config.h"
+#include "JuceHeader.h"
+#include <cstdint>
+#include <vector>
+
+// Sample-accurate parameter automation within a run. Events are sorted by start sample; a step sets its
+// value at the start sample and a ramp moves linearly from the value the parameter had when it started,
+// updating every rampStepSamples. The engine splits blocks at every nextChange() so the plugin sees each
+// value from the exact sample it applies to.
+struct AutomationSchedule {
+    struct Event {
+        int param = 0; // index into getParameterNames()
+        int64_t startSample = 0;
+        int64_t endSample = 0; // == startSample for a step
+        float target = 0.0f;
+    };
+
+    AutomationSchedule(const std::vector<AutomationEventConfig>& events, double sampleRate, int rampStepSamples);
+
+    bool isEmpty() const { return events.empty(); }
+    const std::vector<Event>& getEvents() const { return events; }
+    const std::vector<juce::String>& getParameterNames() const { return parameterNames; }
+    const std::vector<float>& getValues() const { return values; }
+
+    // Starts a run from the given value of every automated parameter
+    void reset(const std::vector<float>& initialValues);
+
+    // First sample after `position` at which any value changes, or INT64_MAX if none does
+    int64_t nextChange(int64_t position) const;
+
+    // Brings every value to `position`; the indices of the parameters that changed are written to `changed`
+    void update(int64_t position, std::vector<int>& changed);
+
+private:
+    std::vector<Event> events;
+    std::vector<juce::String> parameterNames;
+    int rampStepSamples;
+
+    std::vector<float> values;
+    std::vector<float> previousValues;
+    std::vector<float> startValues; // per event: the parameter's value when the event started
+    std::vector<bool> started;
+};
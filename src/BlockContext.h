@@ -5,14 +5,36 @@
 #include <map>
 #include <vector>
 
+// The channels of one bus, structure-of-arrays: one sample pointer per channel, each valid for numSamples
+template <typename SampleType>
+struct ChannelView {
+    const SampleType* const* channels = nullptr;
+    int numChannels = 0;
+    const juce::String* names = nullptr; // per channel: "L", "R", then the layout's abbreviation ("C", "Lfe"...)
+
+    const SampleType* operator[](int ch) const { return channels[ch]; }
+    bool empty() const { return numChannels == 0; }
+};
+
 struct BlockContext {
     int64_t firstSample; // absolute sample index at start of block
     double sampleRate;
     int numSamples;
+
+    // Every channel of the plugin's main input and output buses, and of its sidechain bus (empty when off)
+    ChannelView<float> inputs;
+    ChannelView<float> outputs;
+    ChannelView<float> sidechain;
+
+    // First two channels of inputs / outputs, for analyzers that only measure the front pair
     const float* inL;
     const float* inR; // may be nullptr
     const float* outL;
-    const float* outR;
+    const float* outR; // may be nullptr
+
+    // Double-precision runs: the same buses as processed, before rounding to float (empty otherwise)
+    ChannelView<double> inputsDouble;
+    ChannelView<double> outputsDouble;
 
     // Parameters (normalized [0,1]) for this run in a fixed param order
     std::vector<float> params;
@@ -21,4 +43,14 @@ struct BlockContext {
     int runId;
     std::map<juce::String, float> paramNamedValues; // name -> value
     float inputGainDb;
+
+    // Latency
+    int reportedLatencySamples = 0; // plugin.getLatencySamples() for this run
+    int alignmentSamples = 0;       // output already advanced by this much relative to the input
+
+    // Automation
+    std::vector<float> automationValues; // automated parameter values during this block (AutomationSchedule order)
+    int parameterChanges = 0;            // parameter values changed just before this block
+    double processSeconds = 0.0;         // wall-clock time of the plugin's processBlock for this block
+    bool measured = true;                // false when replayed from another run's recording (no processing time)
 };
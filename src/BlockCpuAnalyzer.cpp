@@ -0,0 +1,84 @@
+#include "BlockCpuAnalyzer.h"
+#include <algorithm>
+#include <iostream>
+
+BlockCpuAnalyzer::BlockCpuAnalyzer(const juce::File& outDir, const std::vector<juce::String>& paramNames,
+                                   const juce::String& signalType)
+    : paramNames(paramNames), signalType(signalType) {
+    juce::String filename = "grid_block_cpu_" + signalType.toLowerCase() + ".csv";
+    csvFile = std::make_unique<std::ofstream>(outDir.getChildFile(filename).getFullPathName().toStdString());
+    if (!csvFile->is_open()) {
+        std::cerr << "Failed to open " << filename.toStdString() << " for writing" << std::endl;
+        csvFile.reset();
+        return;
+    }
+
+    // Header
+    *csvFile << "runId,blockSize,numBlocks,meanUs,maxUs,nsPerSample,meanCpuLoad,maxCpuLoad";
+    for (const auto& paramName : paramNames)
+        *csvFile << "," << paramName.toStdString();
+    *csvFile << ",inputGainDb\n";
+}
+
+BlockCpuAnalyzer::~BlockCpuAnalyzer() {}
+
+void BlockCpuAnalyzer::processRun() {
+    if (!csvFile)
+        return;
+
+    auto& out = *csvFile;
+    for (const auto& [blockSize, stats] : current.sizes) {
+        const double meanSeconds = stats.sumSeconds / (double)stats.numBlocks;
+        const double blockSeconds = (double)blockSize / current.sampleRate;
+        out << current.runId << "," << blockSize << "," << stats.numBlocks << "," << 1e6 * meanSeconds << ","
+            << 1e6 * stats.maxSeconds << "," << 1e9 * meanSeconds / (double)blockSize << ","
+            << meanSeconds / blockSeconds << "," << stats.maxSeconds / blockSeconds;
+        for (const auto& paramName : paramNames) {
+            float value = 0.0f;
+            auto it = current.paramValues.find(paramName);
+            if (it != current.paramValues.end())
+                value = it->second;
+            out << "," << value;
+        }
+        out << "," << current.inputGainDb << "\n";
+    }
+}
+
+void BlockCpuAnalyzer::processBlock(const BlockContext& ctx) {
+    // A new run id means the previous run is complete
+    if (ctx.runId != current.runId) {
+        processRun();
+
+        current.runId = ctx.runId;
+        current.sampleRate = ctx.sampleRate;
+        current.sizes.clear();
+        current.paramValues = ctx.paramNamedValues;
+        current.inputGainDb = ctx.inputGainDb;
+    }
+
+    if (!ctx.measured || ctx.parameterChanges > 0 || ctx.numSamples <= 0)
+        return;
+
+    auto& stats = current.sizes[ctx.numSamples];
+    stats.numBlocks++;
+    stats.sumSeconds += ctx.processSeconds;
+    stats.maxSeconds = std::max(stats.maxSeconds, ctx.processSeconds);
+}
+
+void BlockCpuAnalyzer::finish(const juce::File& outDir) {
+    if (current.runId >= 0) {
+        processRun();
+        current = RunStats();
+    }
+
+    if (csvFile) {
+        csvFile->close();
+        csvFile.reset();
+    }
+}
+
+std::unique_ptr<Analyzer> createBlockCpuAnalyzer(const juce::File& outDir,
+                                                 const std::vector<juce::String>& paramNames,
+                                                 const juce::String& signalType) {
+    return std::make_unique<BlockCpuAnalyzer>(outDir, paramNames, signalType);
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Analyzer.h"
+#include "JuceHeader.h"
+#include <fstream>
+#include <map>
+#include <memory>
+#include <vector>
+
+// Plugin processing time per block, grouped by block size within each run: block count, mean and worst time,
+// time per sample and CPU load (time over the block's real-time duration). Pair with a random or trace block
+// schedule to see how the cost of a block depends on its size. Blocks straight after an automated parameter
+// change (see ParameterChange) and runs replayed from another run's recording are left out.
+struct BlockCpuAnalyzer : public Analyzer {
+    BlockCpuAnalyzer(const juce::File& outDir, const std::vector<juce::String>& paramNames,
+                     const juce::String& signalType);
+    ~BlockCpuAnalyzer() override;
+
+    void processBlock(const BlockContext& ctx) override;
+    void finish(const juce::File& outDir) override;
+
+private:
+    struct SizeStats {
+        int64_t numBlocks = 0;
+        double sumSeconds = 0.0;
+        double maxSeconds = 0.0;
+    };
+
+    struct RunStats {
+        int runId = -1;
+        double sampleRate = 48000.0;
+        std::map<int, SizeStats> sizes; // block size -> times
+        std::map<juce::String, float> paramValues;
+        float inputGainDb = 0.0f;
+    };
+
+    RunStats current;
+    std::vector<juce::String> paramNames;
+    juce::String signalType;
+
+    std::unique_ptr<std::ofstream> csvFile;
+
+    void processRun();
+};
+
+std::unique_ptr<Analyzer> createBlockCpuAnalyzer(const juce::File& outDir,
+                                                 const std::vector<juce::String>& paramNames,
+                                                 const juce::String& signalType);
@@ -0,0 +1,68 @@
+#include "BlockSchedule.h"
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+BlockSchedule::BlockSchedule(const juce::String& typeName, int minBlockSize, const juce::File& traceFile,
+                             uint64_t seed)
+    : minBlockSize(std::max(1, minBlockSize)), seed(seed) {
+    if (typeName.equalsIgnoreCase("random")) {
+        type = Type::Random;
+    } else if (typeName.equalsIgnoreCase("trace")) {
+        std::ifstream file(traceFile.getFullPathName().toStdString());
+        std::string line;
+        while (std::getline(file, line)) {
+            if (!line.empty() && line[0] == '#')
+                continue;
+
+            int value = 0;
+            bool inNumber = false;
+            for (char c : line + " ") {
+                if (std::isdigit((unsigned char)c)) {
+                    value = value * 10 + (c - '0');
+                    inNumber = true;
+                } else if (inNumber) {
+                    if (value > 0)
+                        trace.push_back(value);
+                    value = 0;
+                    inNumber = false;
+                }
+            }
+        }
+
+        if (trace.empty())
+            std::cerr << "Warning: No block sizes read from block trace " << traceFile.getFullPathName()
+                      << "; using fixed blocks" << std::endl;
+        else
+            type = Type::Trace;
+    } else if (!typeName.equalsIgnoreCase("fixed")) {
+        std::cerr << "Warning: Unknown block schedule: " << typeName << "; using fixed blocks" << std::endl;
+    }
+}
+
+void BlockSchedule::reset(int newMaxBlockSize) {
+    maxBlockSize = std::max(1, newMaxBlockSize);
+    tracePosition = 0;
+    rng.seed(seed);
+}
+
+int BlockSchedule::next() {
+    switch (type) {
+        case Type::Random: {
+            std::uniform_int_distribution<int> size(std::min(minBlockSize, maxBlockSize), maxBlockSize);
+            return size(rng);
+        }
+
+        case Type::Trace: {
+            const int size = trace[tracePosition];
+            tracePosition = (tracePosition + 1) % trace.size();
+            return std::min(size, maxBlockSize);
+        }
+
+        case Type::Fixed:
+            break;
+    }
+    return maxBlockSize;
+}
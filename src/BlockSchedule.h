@@ -0,0 +1,34 @@
+#pragma once
+
+#include "JuceHeader.h"
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// Block sizes the engine hands the plugin within a run, emulating a host's callbacks:
+//   "fixed"  - every block is the run's block size (the last one shorter)
+//   "random" - uniform between minBlockSize and the run's block size, from a generator restarted every run so
+//              all runs see the same sequence
+//   "trace"  - sizes recorded from a host, read from a text file (integers separated by whitespace, commas or
+//              new lines; lines starting with '#' are skipped) and looped
+// The run's block size is what the plugin was prepared for, so sizes above it are clamped to it.
+struct BlockSchedule {
+    BlockSchedule(const juce::String& type, int minBlockSize, const juce::File& traceFile, uint64_t seed);
+
+    // Starts a run whose plugin was prepared for maxBlockSize
+    void reset(int maxBlockSize);
+
+    int next();
+
+private:
+    enum class Type { Fixed, Random, Trace };
+
+    Type type = Type::Fixed;
+    int minBlockSize;
+    uint64_t seed;
+    std::vector<int> trace;
+
+    int maxBlockSize = 1;
+    size_t tracePosition = 0;
+    std::mt19937_64 rng;
+};
@@ -1,4 +1,5 @@
 #include "BucketSpec.h"
+#include <algorithm>
 #include <cmath>
 
 BucketSpec::Strategy BucketSpec::strategyFromString(const juce::String& str) {
@@ -59,3 +60,26 @@ std::vector<float> BucketSpec::generateValues() const {
 
     return result;
 }
+
+float BucketSpec::valueAt(double u) const {
+    u = std::clamp(u, 0.0, 1.0);
+    switch (strategy) {
+        case Strategy::ExplicitValues: {
+            if (values.empty())
+                return min;
+            const int index = std::min((int)(u * (double)values.size()), (int)values.size() - 1);
+            return values[index];
+        }
+
+        case Strategy::Log: {
+            const double logMin = std::log10(std::max(min, 1e-6f));
+            const double logMax = std::log10(std::max(max, 1e-6f));
+            return (float)std::pow(10.0, logMin + u * (logMax - logMin));
+        }
+
+        case Strategy::Linear:
+        case Strategy::EdgeAndCenter:
+            break;
+    }
+    return (float)(min + u * (max - min));
+}
@@ -15,4 +15,8 @@ struct BucketSpec {
 
     static Strategy strategyFromString(const juce::String& str);
     std::vector<float> generateValues() const;
+
+    // Value at position u in [0, 1) of the bucket's continuous range, for space-filling sampling: Linear and
+    // EdgeAndCenter interpolate min..max, Log interpolates in log space, ExplicitValues picks values[u * size]
+    float valueAt(double u) const;
 };
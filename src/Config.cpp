@@ -42,6 +42,124 @@ Config Config::fromJsonString(const juce::String& jsonString) {
         config.sweepStartHz = (double)root->getProperty("sweepStartHz");
     if (root->hasProperty("sweepEndHz"))
         config.sweepEndHz = (double)root->getProperty("sweepEndHz");
+    if (root->hasProperty("multiTonePreset"))
+        config.multiTonePreset = root->getProperty("multiTonePreset").toString();
+    if (root->hasProperty("multiToneCount"))
+        config.multiToneCount = (int)root->getProperty("multiToneCount");
+    if (root->hasProperty("multiToneStartHz"))
+        config.multiToneStartHz = (double)root->getProperty("multiToneStartHz");
+    if (root->hasProperty("multiToneEndHz"))
+        config.multiToneEndHz = (double)root->getProperty("multiToneEndHz");
+    if (root->hasProperty("mlsOrder"))
+        config.mlsOrder = (int)root->getProperty("mlsOrder");
+    if (root->hasProperty("seed"))
+        config.seed = (int)root->getProperty("seed");
+    if (root->hasProperty("seedPerRun"))
+        config.seedPerRun = (bool)root->getProperty("seedPerRun");
+    if (root->hasProperty("alignOutput"))
+        config.alignOutput = (bool)root->getProperty("alignOutput");
+    if (root->hasProperty("alignmentSamples"))
+        config.alignmentSamples = (int)root->getProperty("alignmentSamples");
+    if (root->hasProperty("linearityCheck"))
+        config.linearityCheck = (bool)root->getProperty("linearityCheck");
+    if (root->hasProperty("linearityProbeSeconds"))
+        config.linearityProbeSeconds = (double)root->getProperty("linearityProbeSeconds");
+    if (root->hasProperty("linearityToleranceDb"))
+        config.linearityToleranceDb = (double)root->getProperty("linearityToleranceDb");
+
+    // Analyzer settings
+    if (root->hasProperty("linearResponseOverlap"))
+        config.linearResponseOverlap = (double)root->getProperty("linearResponseOverlap");
+    if (root->hasProperty("linearResponseSmoothing"))
+        config.linearResponseSmoothing = (int)root->getProperty("linearResponseSmoothing");
+    if (root->hasProperty("linearResponsePoints"))
+        config.linearResponsePoints = (int)root->getProperty("linearResponsePoints");
+    if (root->hasProperty("linearResponseEnvelope"))
+        config.linearResponseEnvelope = (bool)root->getProperty("linearResponseEnvelope");
+    if (root->hasProperty("spectrogramFftSize"))
+        config.spectrogramFftSize = (int)root->getProperty("spectrogramFftSize");
+    if (root->hasProperty("spectrogramHop"))
+        config.spectrogramHop = (int)root->getProperty("spectrogramHop");
+    if (root->hasProperty("spectrogramWindow"))
+        config.spectrogramWindow = root->getProperty("spectrogramWindow").toString();
+    if (root->hasProperty("spectrogramFloorDb"))
+        config.spectrogramFloorDb = (float)root->getProperty("spectrogramFloorDb");
+    if (root->hasProperty("transferCurveBins"))
+        config.transferCurveBins = (int)root->getProperty("transferCurveBins");
+    if (root->hasProperty("transferCurveStereo"))
+        config.transferCurveStereo = (bool)root->getProperty("transferCurveStereo");
+
+    // Parameter screening
+    if (root->hasProperty("screening"))
+        config.screening = (bool)root->getProperty("screening");
+    if (root->hasProperty("screeningTrajectories"))
+        config.screeningTrajectories = (int)root->getProperty("screeningTrajectories");
+    if (root->hasProperty("screeningSeconds"))
+        config.screeningSeconds = (double)root->getProperty("screeningSeconds");
+    if (root->hasProperty("screeningThreshold"))
+        config.screeningThreshold = (double)root->getProperty("screeningThreshold");
+    if (root->hasProperty("screeningCollapse"))
+        config.screeningCollapse = (bool)root->getProperty("screeningCollapse");
+    if (root->hasProperty("screeningMetrics")) {
+        auto metricsArray = root->getProperty("screeningMetrics");
+        if (metricsArray.isArray()) {
+            for (int i = 0; i < metricsArray.size(); ++i) {
+                config.screeningMetrics.push_back(metricsArray[i].toString());
+            }
+        }
+    }
+
+    // Staircase levels
+    if (root->hasProperty("staircaseLevelsDb")) {
+        auto levelArray = root->getProperty("staircaseLevelsDb");
+        if (levelArray.isArray()) {
+            for (int i = 0; i < levelArray.size(); ++i) {
+                config.staircaseLevelsDb.push_back((float)levelArray[i]);
+            }
+        }
+    }
+
+    // Grid sampling and host configurations
+    if (root->hasProperty("gridSampling"))
+        config.gridSampling = root->getProperty("gridSampling").toString();
+    if (root->hasProperty("gridSamples"))
+        config.gridSamples = (int)root->getProperty("gridSamples");
+    if (root->hasProperty("dedupeDiscrete"))
+        config.dedupeDiscrete = (bool)root->getProperty("dedupeDiscrete");
+    if (root->hasProperty("sampleRateBuckets")) {
+        auto rateArray = root->getProperty("sampleRateBuckets");
+        if (rateArray.isArray()) {
+            for (int i = 0; i < rateArray.size(); ++i) {
+                config.sampleRateBuckets.push_back((double)rateArray[i]);
+            }
+        }
+    }
+    if (root->hasProperty("blockSizeBuckets")) {
+        auto blockArray = root->getProperty("blockSizeBuckets");
+        if (blockArray.isArray()) {
+            for (int i = 0; i < blockArray.size(); ++i) {
+                config.blockSizeBuckets.push_back((int)blockArray[i]);
+            }
+        }
+    }
+    if (root->hasProperty("precision"))
+        config.precision = root->getProperty("precision").toString();
+    if (root->hasProperty("inputChannels"))
+        config.inputChannels = (int)root->getProperty("inputChannels");
+    if (root->hasProperty("outputChannels"))
+        config.outputChannels = (int)root->getProperty("outputChannels");
+    if (root->hasProperty("sidechain"))
+        config.sidechain = root->getProperty("sidechain").toString();
+    if (root->hasProperty("sidechainGainDb"))
+        config.sidechainGainDb = (float)root->getProperty("sidechainGainDb");
+    if (root->hasProperty("maxPreparedInstances"))
+        config.maxPreparedInstances = (int)root->getProperty("maxPreparedInstances");
+    if (root->hasProperty("blockSchedule"))
+        config.blockSchedule = root->getProperty("blockSchedule").toString();
+    if (root->hasProperty("minBlockSize"))
+        config.minBlockSize = (int)root->getProperty("minBlockSize");
+    if (root->hasProperty("blockTraceFile"))
+        config.blockTraceFile = root->getProperty("blockTraceFile").toString();
 
     // Input gain buckets
     if (root->hasProperty("inputGainBucketsDb")) {
@@ -87,6 +205,32 @@ Config Config::fromJsonString(const juce::String& jsonString) {
         }
     }
 
+    // Automation events
+    if (root->hasProperty("automationRampStepSamples"))
+        config.automationRampStepSamples = (int)root->getProperty("automationRampStepSamples");
+    if (root->hasProperty("automation")) {
+        auto eventsArray = root->getProperty("automation");
+        if (eventsArray.isArray()) {
+            for (int i = 0; i < eventsArray.size(); ++i) {
+                auto eventObj = eventsArray[i].getDynamicObject();
+                if (eventObj == nullptr)
+                    continue;
+
+                AutomationEventConfig event;
+                if (eventObj->hasProperty("paramName"))
+                    event.paramName = eventObj->getProperty("paramName").toString();
+                if (eventObj->hasProperty("timeSeconds"))
+                    event.timeSeconds = (double)eventObj->getProperty("timeSeconds");
+                if (eventObj->hasProperty("rampSeconds"))
+                    event.rampSeconds = (double)eventObj->getProperty("rampSeconds");
+                if (eventObj->hasProperty("value"))
+                    event.value = (float)eventObj->getProperty("value");
+
+                config.automation.push_back(event);
+            }
+        }
+    }
+
     // Analyzers
     if (root->hasProperty("analyzers")) {
         auto analyzersArray = root->getProperty("analyzers");
@@ -13,17 +13,70 @@ struct ParameterBucketConfig {
     std::vector<float> values;
 };
 
+// Parameter change inside a run: a step (rampSeconds = 0) or a linear ramp to `value` starting at timeSeconds
+struct AutomationEventConfig {
+    juce::String paramName;
+    double timeSeconds = 0.0;
+    double rampSeconds = 0.0;
+    float value = 0.0f; // normalized [0,1]
+};
+
 struct Config {
     juce::String pluginPath;
     double sampleRate = 48000.0;
     double seconds = 5.0;
     int blockSize = 256;
-    juce::String signalType; // "sine", "noise", "sweep"
+    juce::String signalType; // "sine", "noise", "sweep", "multitone", "mls", "staircase"
     double sineFrequency = 1000.0;
     double sweepStartHz = 20.0;
     double sweepEndHz = 20000.0;
+    juce::String multiTonePreset = "log"; // "log", "smpte", "ccif"
+    int multiToneCount = 31;
+    double multiToneStartHz = 20.0;
+    double multiToneEndHz = 20000.0;
+    int mlsOrder = 15; // MLS period 2^order - 1 samples (10..20)
+    int seed = 0;      // base seed for random stimuli; each run derives its own from its runId
+    bool seedPerRun = true;              // false gives every run the same random stimulus, from seed alone
+    bool alignOutput = false;            // advance the output by the plugin latency before analysis
+    int alignmentSamples = -1;           // latency to compensate when aligning; -1 uses the plugin's reported latency
+    bool linearityCheck = false;         // measure linear settings at one gain and scale to the other buckets
+    double linearityProbeSeconds = 0.25; // length of each of the four probe passes
+    double linearityToleranceDb = -60.0; // largest residual (relative to the output) still counted as linear
+    double linearResponseOverlap = 0.5;  // Welch segment overlap for LinearResponse (0, 0.5, 0.75)
+    int linearResponseSmoothing = 0;     // 1/N-octave smoothing of LinearResponse (0 = none; 3, 6, 12, 24 typical)
+    int linearResponsePoints = 0;        // log-spaced LinearResponse frequencies per run (0 = every FFT bin)
+    bool linearResponseEnvelope = false; // add the min/max magDb of the bins behind each LinearResponse row
+    int transferCurveBins = 512;
+    bool transferCurveStereo = false;           // also bin inR -> outR and every further channel pair
+    int spectrogramFftSize = 2048;              // Spectrogram frame length (power of two)
+    int spectrogramHop = 512;                   // samples between Spectrogram frames
+    juce::String spectrogramWindow = "hann";    // "hann", "hamming", "blackman", "rect"
+    float spectrogramFloorDb = -160.0f;         // lowest level Spectrogram stores; codes count 0.01 dB above it
+    bool screening = false;                     // Morris screening of parameterBuckets before the grid
+    int screeningTrajectories = 10;             // runs = trajectories * (bucketed parameters + 1)
+    double screeningSeconds = 1.0;              // duration of each screening run
+    double screeningThreshold = 0.05;           // relative influence below which a parameter is inert
+    bool screeningCollapse = false;             // fix inert parameters at their middle bucket value
+    std::vector<juce::String> screeningMetrics; // "rmsDb", "peakDb", "crestDb", "zeroCrossingRate"
+    std::vector<float> staircaseLevelsDb;       // staircase step levels (dBFS peak); empty uses inputGainBucketsDb
     std::vector<float> inputGainBucketsDb;
     std::vector<ParameterBucketConfig> parameterBuckets;
+    juce::String gridSampling = "cartesian"; // "cartesian", "lhs", "sobol", "halton"
+    int gridSamples = 64;                    // parameter combinations drawn when gridSampling is not cartesian
+    bool dedupeDiscrete = true;              // measure equivalent switch/choice settings once
+    std::vector<double> sampleRateBuckets;   // host sample rates to run the grid at; empty uses sampleRate
+    std::vector<int> blockSizeBuckets;       // host block sizes to run the grid at; empty uses blockSize
+    juce::String precision = "float";        // "float", "double" or "both" (each setting at both precisions)
+    int inputChannels = 0;                   // main input bus channels to negotiate; 0 keeps the plugin's default
+    int outputChannels = 0;                  // main output bus channels to negotiate; 0 keeps the plugin's default
+    juce::String sidechain = "off";          // "off" (bus disabled), "silence", "stimulus"
+    float sidechainGainDb = 0.0f;            // sidechain stimulus level relative to the main input
+    int maxPreparedInstances = 4;            // extra plugin instances kept prepared for other host configurations
+    juce::String blockSchedule = "fixed";    // "fixed", "random", "trace"
+    int minBlockSize = 1;                    // smallest random block; the largest is the run's block size
+    juce::String blockTraceFile;             // block sizes recorded from a host, for the "trace" schedule
+    std::vector<AutomationEventConfig> automation;
+    int automationRampStepSamples = 32; // ramps update their parameter this often, splitting the block there
     std::vector<juce::String> analyzers;
 
     static Config fromJson(const juce::File& jsonFile);
@@ -0,0 +1,187 @@
+#include "DynamicsAnalyzer.h"
+#include "SignalGenerator.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+DynamicsAnalyzer::DynamicsAnalyzer(const juce::File& outDir, double frequency, double duration,
+                                   const std::vector<float>& stepsDb, const std::vector<juce::String>& paramNames,
+                                   const juce::String& signalType)
+    : frequency(frequency), duration(duration), stepsDb(stepsDb), paramNames(paramNames), signalType(signalType) {
+    juce::String filename = "grid_dynamics_" + signalType.toLowerCase() + ".csv";
+    csvFile = std::make_unique<std::ofstream>(outDir.getChildFile(filename).getFullPathName().toStdString());
+    if (!csvFile->is_open()) {
+        std::cerr << "Failed to open " << filename.toStdString() << " for writing" << std::endl;
+        csvFile.reset();
+        return;
+    }
+
+    // Header
+    *csvFile << "runId,step,transition,levelDb,inputRmsDb,outputRmsDb,gainDb,gainChangeDb,t63Ms,t90Ms";
+    for (const auto& paramName : paramNames)
+        *csvFile << "," << paramName.toStdString();
+    *csvFile << ",inputGainDb\n";
+}
+
+DynamicsAnalyzer::~DynamicsAnalyzer() {}
+
+void DynamicsAnalyzer::prepare(double newSampleRate) {
+    sampleRate = newSampleRate;
+    stepSamples = StaircaseGenerator::stepLength(duration, sampleRate, (int)stepsDb.size());
+
+    // Whole tone periods spanning at least 1 ms, so the window RMS barely ripples with the tone phase
+    const double periods = std::max(1.0, std::ceil(0.001 * frequency));
+    windowSamples = std::max(1, (int)std::lround(periods * sampleRate / std::max(1.0, frequency)));
+}
+
+void DynamicsAnalyzer::processStep() {
+    auto& run = current;
+    if (!csvFile || run.step < 0 || run.windows.empty())
+        return;
+
+    // Steady state: the last quarter of the step
+    const int numWindows = (int)run.windows.size();
+    const int steadyStart = numWindows - std::max(1, numWindows / 4);
+    double inSq = 0.0, outSq = 0.0;
+    for (int w = steadyStart; w < numWindows; ++w) {
+        inSq += run.windows[w].inSq;
+        outSq += run.windows[w].outSq;
+    }
+    if (inSq <= 0.0)
+        return;
+
+    const double steadySamples = (double)(numWindows - steadyStart) * (double)windowSamples;
+    const double inputRmsDb = 10.0 * std::log10(inSq / steadySamples);
+    const double outputRmsDb = 10.0 * std::log10(std::max(outSq, 1e-30) / steadySamples);
+    const double gainDb = outputRmsDb - inputRmsDb;
+
+    const char* transition = "start";
+    double gainChangeDb = 0.0;
+    double t63 = -1.0, t90 = -1.0;
+    if (run.hasPreviousGain) {
+        transition = stepsDb[run.step] > stepsDb[run.step - 1] ? "attack" : "release";
+        gainChangeDb = gainDb - (double)run.previousGainDb;
+
+        if (std::abs(gainChangeDb) >= (double)minTransitionDb) {
+            // Progress of the window gain from the previous steady state (0) to this one (1), timed at window
+            // centres and interpolated linearly to the first crossing of each target
+            const double windowMs = 1000.0 * (double)windowSamples / sampleRate;
+            double lastTime = 0.0, lastProgress = 0.0;
+            for (int w = 0; w < numWindows && t90 < 0.0; ++w) {
+                const auto& window = run.windows[w];
+                if (window.inSq <= 0.0)
+                    continue;
+
+                const double windowGainDb = 10.0 * std::log10(std::max(window.outSq, 1e-30) / window.inSq);
+                const double progress = (windowGainDb - (double)run.previousGainDb) / gainChangeDb;
+                const double time = ((double)w + 0.5) * windowMs;
+                auto crossing = [&](double target) {
+                    if (progress <= lastProgress)
+                        return time;
+                    return lastTime + (target - lastProgress) / (progress - lastProgress) * (time - lastTime);
+                };
+                if (t63 < 0.0 && progress >= 0.632)
+                    t63 = crossing(0.632);
+                if (t90 < 0.0 && progress >= 0.9)
+                    t90 = crossing(0.9);
+
+                lastTime = time;
+                lastProgress = progress;
+            }
+        }
+    }
+
+    auto& out = *csvFile;
+    out << run.runId << "," << run.step << "," << transition << "," << stepsDb[run.step] << "," << inputRmsDb << ","
+        << outputRmsDb << "," << gainDb << "," << gainChangeDb << ",";
+    if (t63 >= 0.0)
+        out << t63;
+    out << ",";
+    if (t90 >= 0.0)
+        out << t90;
+
+    for (const auto& paramName : paramNames) {
+        float value = 0.0f;
+        auto it = run.paramValues.find(paramName);
+        if (it != run.paramValues.end())
+            value = it->second;
+        out << "," << value;
+    }
+    out << "," << run.inputGainDb << "\n";
+
+    run.previousGainDb = (float)gainDb;
+    run.hasPreviousGain = true;
+}
+
+void DynamicsAnalyzer::processBlock(const BlockContext& ctx) {
+    if (stepsDb.empty())
+        return;
+
+    // A new run id means the previous run is complete
+    if (ctx.runId != current.runId) {
+        processStep();
+
+        // Step and window lengths are in samples, so a run at another sample rate needs them recomputed
+        if (ctx.sampleRate != sampleRate)
+            prepare(ctx.sampleRate);
+
+        current.runId = ctx.runId;
+        current.step = -1;
+        current.windows.clear();
+        current.partial = {};
+        current.hasPreviousGain = false;
+        current.paramValues = ctx.paramNamedValues;
+        current.inputGainDb = ctx.inputGainDb;
+    }
+
+    const int numSteps = (int)stepsDb.size();
+    int i = 0;
+    while (i < ctx.numSamples) {
+        const int64_t position = ctx.firstSample + i;
+        const int step = (int)std::min<int64_t>(position / stepSamples, numSteps - 1);
+        if (step != current.step) {
+            processStep();
+            current.step = step;
+            current.windows.clear();
+            current.partial = {};
+        }
+
+        // Windows restart at every step boundary; a partial window at the end of a step is dropped
+        const int64_t offset = position - (int64_t)step * stepSamples;
+        const int64_t toWindowEnd = windowSamples - offset % windowSamples;
+        const int64_t toStepEnd = step == numSteps - 1 ? toWindowEnd : stepSamples - offset;
+        const int count = (int)std::min<int64_t>(ctx.numSamples - i, std::min(toWindowEnd, toStepEnd));
+
+        double inSq = 0.0, outSq = 0.0;
+        for (int j = i; j < i + count; ++j) {
+            inSq += (double)ctx.inL[j] * (double)ctx.inL[j];
+            outSq += (double)ctx.outL[j] * (double)ctx.outL[j];
+        }
+        current.partial.inSq += inSq;
+        current.partial.outSq += outSq;
+
+        if (count == toWindowEnd) {
+            current.windows.push_back(current.partial);
+            current.partial = {};
+        }
+        i += count;
+    }
+}
+
+void DynamicsAnalyzer::finish(const juce::File& outDir) {
+    processStep();
+    current.runId = -1;
+    current.step = -1;
+
+    if (csvFile) {
+        csvFile->close();
+        csvFile.reset();
+    }
+}
+
+std::unique_ptr<Analyzer> createDynamicsAnalyzer(const juce::File& outDir, double frequency, double duration,
+                                                 const std::vector<float>& stepsDb,
+                                                 const std::vector<juce::String>& paramNames,
+                                                 const juce::String& signalType) {
+    return std::make_unique<DynamicsAnalyzer>(outDir, frequency, duration, stepsDb, paramNames, signalType);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Analyzer.h"
+#include "JuceHeader.h"
+#include <fstream>
+#include <map>
+#include <memory>
+#include <vector>
+
+// Static curve and attack/release timing of a dynamics processor from one level-staircase run. The output
+// and input are reduced to short RMS windows (whole tone periods, at least 1 ms) within each step; the gain
+// over the last quarter of a step is its steady-state point on the static curve, and the gain trajectory
+// from the previous step's steady state to this one gives the time to 63% and 90% of the change (attack on
+// rising steps, release on falling ones). Step boundaries are taken from the stimulus schedule, so enable
+// alignOutput for plugins with latency.
+struct DynamicsAnalyzer : public Analyzer {
+    static constexpr float minTransitionDb = 0.5f; // smaller gain changes get no timing
+
+    DynamicsAnalyzer(const juce::File& outDir, double frequency, double duration, const std::vector<float>& stepsDb,
+                     const std::vector<juce::String>& paramNames, const juce::String& signalType);
+    ~DynamicsAnalyzer() override;
+
+    void processBlock(const BlockContext& ctx) override;
+    void finish(const juce::File& outDir) override;
+
+private:
+    struct Window {
+        double inSq = 0.0;
+        double outSq = 0.0;
+    };
+
+    struct RunEnvelope {
+        int runId = -1;
+        int step = -1;
+        std::vector<Window> windows; // completed windows of the current step
+        Window partial;
+        float previousGainDb = 0.0f;
+        bool hasPreviousGain = false;
+        std::map<juce::String, float> paramValues;
+        float inputGainDb = 0.0f;
+    };
+
+    RunEnvelope current;
+    double frequency;
+    double duration;
+    std::vector<float> stepsDb;
+    std::vector<juce::String> paramNames;
+    juce::String signalType;
+
+    int64_t stepSamples = 0;
+    int windowSamples = 0;
+    double sampleRate = 0.0;
+
+    std::unique_ptr<std::ofstream> csvFile;
+
+    void prepare(double newSampleRate);
+    void processStep();
+};
+
+std::unique_ptr<Analyzer> createDynamicsAnalyzer(const juce::File& outDir, double frequency, double duration,
+                                                 const std::vector<float>& stepsDb,
+                                                 const std::vector<juce::String>& paramNames,
+                                                 const juce::String& signalType);
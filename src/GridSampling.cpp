@@ -0,0 +1,170 @@
+#include "GridSampling.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+#include <random>
+
+std::vector<std::vector<double>> latinHypercubePoints(int numPoints, int dimensions, uint64_t seed) {
+    std::vector<std::vector<double>> points(std::max(0, numPoints), std::vector<double>(std::max(0, dimensions)));
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> jitter(0.0, 1.0);
+
+    std::vector<int> strata(points.size());
+    for (int d = 0; d < dimensions; ++d) {
+        std::iota(strata.begin(), strata.end(), 0);
+        std::shuffle(strata.begin(), strata.end(), rng);
+        for (int i = 0; i < numPoints; ++i)
+            points[i][d] = ((double)strata[i] + jitter(rng)) / (double)numPoints;
+    }
+    return points;
+}
+
+static uint32_t reverseBits(uint32_t x) {
+    x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+    x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+    x = ((x >> 4) & 0x0F0F0F0Fu) | ((x & 0x0F0F0F0Fu) << 4);
+    x = ((x >> 8) & 0x00FF00FFu) | ((x & 0x00FF00FFu) << 8);
+    return (x >> 16) | (x << 16);
+}
+
+// Owen (nested uniform) scramble of a 32-bit binary fraction: a Laine-Karras style hash applied to the
+// bit-reversed value permutes each digit depending only on the digits above it (Burley, "Practical
+// Hash-based Owen Scrambling", 2020)
+static uint32_t owenScramble(uint32_t x, uint32_t seed) {
+    x = reverseBits(x);
+    x += seed;
+    x ^= x * 0x6C50B47Cu;
+    x ^= x * 0xB82F1E52u;
+    x ^= x * 0xC7AFE638u;
+    x ^= x * 0x8D22F6E6u;
+    return reverseBits(x);
+}
+
+std::vector<std::vector<double>> sobolPoints(int numPoints, int dimensions, uint64_t seed) {
+    // Primitive polynomial degree s, coefficients a and initial direction numbers m for axes 2..21
+    // (Joe & Kuo, new-joe-kuo-6.21201); axis 1 is the van der Corput sequence
+    struct Direction {
+        int s;
+        uint32_t a;
+        uint32_t m[7];
+    };
+    static const Direction table[maxSobolDimensions - 1] = {
+        {1, 0, {1}},
+        {2, 1, {1, 3}},
+        {3, 1, {1, 3, 1}},
+        {3, 2, {1, 1, 1}},
+        {4, 1, {1, 1, 3, 3}},
+        {4, 4, {1, 3, 5, 13}},
+        {5, 2, {1, 1, 5, 5, 17}},
+        {5, 4, {1, 1, 5, 5, 5}},
+        {5, 7, {1, 1, 7, 11, 19}},
+        {5, 11, {1, 1, 5, 1, 1}},
+        {5, 13, {1, 1, 1, 3, 11}},
+        {5, 14, {1, 3, 5, 5, 31}},
+        {6, 1, {1, 3, 3, 9, 7, 49}},
+        {6, 13, {1, 1, 1, 15, 21, 21}},
+        {6, 16, {1, 3, 1, 13, 27, 49}},
+        {6, 19, {1, 1, 1, 15, 7, 5}},
+        {6, 22, {1, 3, 1, 15, 13, 25}},
+        {6, 25, {1, 1, 5, 5, 19, 61}},
+        {7, 1, {1, 3, 7, 11, 23, 15, 103}},
+        {7, 4, {1, 3, 7, 13, 13, 15, 69}},
+    };
+
+    constexpr int bits = 32;
+    dimensions = std::clamp(dimensions, 0, maxSobolDimensions);
+    std::vector<std::array<uint32_t, bits>> directions(dimensions);
+    for (int d = 0; d < dimensions; ++d) {
+        auto& v = directions[d];
+        if (d == 0) {
+            for (int k = 0; k < bits; ++k)
+                v[k] = 1u << (bits - 1 - k);
+            continue;
+        }
+
+        const auto& entry = table[d - 1];
+        for (int k = 0; k < entry.s; ++k)
+            v[k] = entry.m[k] << (bits - 1 - k);
+        for (int k = entry.s; k < bits; ++k) {
+            v[k] = v[k - entry.s] ^ (v[k - entry.s] >> entry.s);
+            for (int j = 1; j < entry.s; ++j) {
+                if ((entry.a >> (entry.s - 1 - j)) & 1u)
+                    v[k] ^= v[k - j];
+            }
+        }
+    }
+
+    std::mt19937_64 rng(seed);
+    std::vector<uint32_t> scrambleSeeds(dimensions);
+    for (auto& s : scrambleSeeds)
+        s = (uint32_t)rng();
+
+    // Gray-code order: point i differs from point i - 1 in the direction of i's lowest set bit
+    std::vector<std::vector<double>> points(std::max(0, numPoints), std::vector<double>(dimensions));
+    std::vector<uint32_t> x(dimensions, 0u);
+    for (int i = 0; i < numPoints; ++i) {
+        if (i > 0) {
+            int c = 0;
+            while (((uint32_t)i >> c & 1u) == 0u)
+                ++c;
+            for (int d = 0; d < dimensions; ++d)
+                x[d] ^= directions[d][c];
+        }
+        for (int d = 0; d < dimensions; ++d)
+            points[i][d] = (double)owenScramble(x[d], scrambleSeeds[d]) / 4294967296.0;
+    }
+    return points;
+}
+
+std::vector<std::vector<double>> haltonPoints(int numPoints, int dimensions, uint64_t seed) {
+    std::vector<int> primes;
+    for (int candidate = 2; (int)primes.size() < dimensions; ++candidate) {
+        bool isPrime = true;
+        for (int p : primes) {
+            if (p * p > candidate)
+                break;
+            if (candidate % p == 0) {
+                isPrime = false;
+                break;
+            }
+        }
+        if (isPrime)
+            primes.push_back(candidate);
+    }
+
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::vector<double> shifts(std::max(0, dimensions));
+    for (auto& shift : shifts)
+        shift = uniform(rng);
+
+    // Radical inverse of i + 1 (index 0 would put every axis at 0), shifted modulo 1
+    std::vector<std::vector<double>> points(std::max(0, numPoints), std::vector<double>(std::max(0, dimensions)));
+    for (int i = 0; i < numPoints; ++i) {
+        for (int d = 0; d < dimensions; ++d) {
+            const int base = primes[d];
+            double inverse = 0.0, scale = 1.0 / (double)base;
+            for (int n = i + 1; n > 0; n /= base, scale /= (double)base)
+                inverse += (double)(n % base) * scale;
+            points[i][d] = std::fmod(inverse + shifts[d], 1.0);
+        }
+    }
+    return points;
+}
+
+std::vector<std::vector<double>> generateSamplePoints(const juce::String& method, int numPoints, int dimensions,
+                                                      uint64_t seed) {
+    if (method.equalsIgnoreCase("sobol")) {
+        if (dimensions <= maxSobolDimensions)
+            return sobolPoints(numPoints, dimensions, seed);
+        std::cerr << "Warning: Sobol sampling supports up to " << maxSobolDimensions
+                  << " parameters; using Latin hypercube" << std::endl;
+    } else if (method.equalsIgnoreCase("halton")) {
+        return haltonPoints(numPoints, dimensions, seed);
+    } else if (!method.equalsIgnoreCase("lhs")) {
+        std::cerr << "Warning: Unknown grid sampling: " << method << "; using Latin hypercube" << std::endl;
+    }
+    return latinHypercubePoints(numPoints, dimensions, seed);
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "JuceHeader.h"
+#include <cstdint>
+#include <vector>
+
+// Space-filling designs: numPoints points in [0, 1)^dimensions, one vector per point. The same seed always
+// gives the same design.
+//   "lhs"    - Latin hypercube: every axis split into numPoints strata, each stratum used exactly once
+//   "sobol"  - Sobol sequence (Joe-Kuo direction numbers, up to maxSobolDimensions) with Owen scrambling;
+//              best balanced at power-of-two point counts
+//   "halton" - Halton sequence over the first primes with a random per-axis shift; degrades past ~10 axes
+std::vector<std::vector<double>> latinHypercubePoints(int numPoints, int dimensions, uint64_t seed);
+std::vector<std::vector<double>> sobolPoints(int numPoints, int dimensions, uint64_t seed);
+std::vector<std::vector<double>> haltonPoints(int numPoints, int dimensions, uint64_t seed);
+
+constexpr int maxSobolDimensions = 21;
+
+// Dispatches on the method name above; unknown names fall back to "lhs"
+std::vector<std::vector<double>> generateSamplePoints(const juce::String& method, int numPoints, int dimensions,
+                                                      uint64_t seed);
@@ -0,0 +1,153 @@
+#include "LatencyAnalyzer.h"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <iostream>
+
+LatencyAnalyzer::LatencyAnalyzer(const juce::File& outDir, const std::vector<juce::String>& paramNames,
+                                 const juce::String& signalType)
+    : paramNames(paramNames), signalType(signalType) {
+    juce::String filename = "grid_latency_" + signalType.toLowerCase() + ".csv";
+    csvFile = std::make_unique<std::ofstream>(outDir.getChildFile(filename).getFullPathName().toStdString());
+    if (!csvFile->is_open()) {
+        std::cerr << "Failed to open " << filename.toStdString() << " for writing" << std::endl;
+        csvFile.reset();
+        return;
+    }
+
+    // Header
+    *csvFile << "runId,reportedLatencySamples,alignmentSamples,measuredDelaySamples,measuredDelayMs,"
+                "latencyErrorSamples,correlation,polarity";
+    for (const auto& paramName : paramNames)
+        *csvFile << "," << paramName.toStdString();
+    *csvFile << ",inputGainDb\n";
+
+    // Linear (not circular) correlation of two maxCaptureSamples captures
+    int order = 0;
+    while ((1 << order) < 2 * maxCaptureSamples)
+        ++order;
+    fft = std::make_unique<juce::dsp::FFT>(order);
+}
+
+LatencyAnalyzer::~LatencyAnalyzer() {}
+
+void LatencyAnalyzer::processRun() {
+    if (!csvFile || current.in.empty())
+        return;
+
+    const int size = fft->getSize();
+    const int length = (int)current.in.size();
+
+    double energyIn = 0.0, energyOut = 0.0;
+    for (int n = 0; n < length; ++n) {
+        energyIn += (double)current.in[n] * (double)current.in[n];
+        energyOut += (double)current.out[n] * (double)current.out[n];
+    }
+    if (energyIn <= 0.0 || energyOut <= 0.0)
+        return;
+
+    // r[lag] = sum_n in[n] * out[n + lag] = IFFT(conj(IN) * OUT); negative lags wrap to the top
+    inScratch.assign(2 * size, 0.0f);
+    outScratch.assign(2 * size, 0.0f);
+    std::copy(current.in.begin(), current.in.end(), inScratch.begin());
+    std::copy(current.out.begin(), current.out.end(), outScratch.begin());
+    fft->performRealOnlyForwardTransform(inScratch.data(), true);
+    fft->performRealOnlyForwardTransform(outScratch.data(), true);
+
+    auto* inBins = reinterpret_cast<std::complex<float>*>(inScratch.data());
+    auto* outBins = reinterpret_cast<std::complex<float>*>(outScratch.data());
+    for (int k = 0; k <= size / 2; ++k)
+        outBins[k] *= std::conj(inBins[k]);
+    for (int k = 1; k < size / 2; ++k)
+        outBins[size - k] = std::conj(outBins[k]);
+    fft->performRealOnlyInverseTransform(outScratch.data());
+
+    const int maxLag = std::min(maxLagSamples, length - 1);
+    auto correlationAt = [&](int lag) { return outScratch[(lag + size) % size]; };
+
+    int peakLag = 0;
+    float peakMagnitude = -1.0f;
+    for (int lag = -maxLag; lag <= maxLag; ++lag) {
+        const float magnitude = std::abs(correlationAt(lag));
+        if (magnitude > peakMagnitude) {
+            peakMagnitude = magnitude;
+            peakLag = lag;
+        }
+    }
+
+    // Parabolic interpolation of |r| around the peak
+    double fraction = 0.0;
+    if (peakLag > -maxLag && peakLag < maxLag) {
+        const double a = std::abs(correlationAt(peakLag - 1));
+        const double b = (double)peakMagnitude;
+        const double c = std::abs(correlationAt(peakLag + 1));
+        const double denominator = a - 2.0 * b + c;
+        if (denominator < 0.0)
+            fraction = std::clamp(0.5 * (a - c) / denominator, -0.5, 0.5);
+    }
+
+    // The peak's value straight from the captures, so the normalisation does not depend on how the FFT
+    // scales its inverse; a unit-gain passthrough reads 1
+    double peak = 0.0;
+    for (int n = std::max(0, -peakLag); n < std::min(length, length - peakLag); ++n)
+        peak += (double)current.in[n] * (double)current.out[n + peakLag];
+    const double correlation = std::abs(peak) / std::sqrt(energyIn * energyOut);
+    const double delaySamples = (double)current.alignmentSamples + (double)peakLag + fraction;
+
+    auto& out = *csvFile;
+    out << current.runId << "," << current.reportedLatencySamples << "," << current.alignmentSamples << ","
+        << delaySamples << "," << 1000.0 * delaySamples / current.sampleRate << ","
+        << delaySamples - (double)current.reportedLatencySamples << "," << correlation << ","
+        << (peak < 0.0 ? -1 : 1);
+
+    for (const auto& paramName : paramNames) {
+        float value = 0.0f;
+        auto it = current.paramValues.find(paramName);
+        if (it != current.paramValues.end())
+            value = it->second;
+        out << "," << value;
+    }
+    out << "," << current.inputGainDb << "\n";
+}
+
+void LatencyAnalyzer::processBlock(const BlockContext& ctx) {
+    // A new run id means the previous run is complete
+    if (ctx.runId != current.runId) {
+        if (current.runId >= 0)
+            processRun();
+
+        current.runId = ctx.runId;
+        current.in.clear();
+        current.out.clear();
+        current.in.reserve(maxCaptureSamples);
+        current.out.reserve(maxCaptureSamples);
+        current.reportedLatencySamples = ctx.reportedLatencySamples;
+        current.alignmentSamples = ctx.alignmentSamples;
+        current.sampleRate = ctx.sampleRate;
+        current.paramValues = ctx.paramNamedValues;
+        current.inputGainDb = ctx.inputGainDb;
+    }
+
+    const int toCopy = std::min(ctx.numSamples, maxCaptureSamples - (int)current.in.size());
+    if (toCopy > 0) {
+        current.in.insert(current.in.end(), ctx.inL, ctx.inL + toCopy);
+        current.out.insert(current.out.end(), ctx.outL, ctx.outL + toCopy);
+    }
+}
+
+void LatencyAnalyzer::finish(const juce::File& outDir) {
+    if (current.runId >= 0) {
+        processRun();
+        current.runId = -1;
+    }
+
+    if (csvFile) {
+        csvFile->close();
+        csvFile.reset();
+    }
+}
+
+std::unique_ptr<Analyzer> createLatencyAnalyzer(const juce::File& outDir, const std::vector<juce::String>& paramNames,
+                                                const juce::String& signalType) {
+    return std::make_unique<LatencyAnalyzer>(outDir, paramNames, signalType);
+}
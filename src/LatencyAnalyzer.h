@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Analyzer.h"
+#include "JuceHeader.h"
+#include <fstream>
+#include <map>
+#include <memory>
+#include <vector>
+
+// Input->output delay per run from the FFT cross-correlation of the first maxCaptureSamples of inL and
+// outL. The correlation peak (by magnitude, so polarity inversion is reported rather than missed) is
+// refined with parabolic interpolation to a fractional-sample delay and compared with the latency the
+// plugin reports. Any alignment the engine already applied is added back, so the delay is always the
+// plugin's own. Needs a broadband stimulus (noise, sweep, MLS); periodic tones give ambiguous peaks.
+struct LatencyAnalyzer : public Analyzer {
+    static constexpr int maxCaptureSamples = 1 << 16;
+    static constexpr int maxLagSamples = 1 << 14;
+
+    LatencyAnalyzer(const juce::File& outDir, const std::vector<juce::String>& paramNames,
+                    const juce::String& signalType);
+    ~LatencyAnalyzer() override;
+
+    void processBlock(const BlockContext& ctx) override;
+    void finish(const juce::File& outDir) override;
+
+private:
+    struct RunCapture {
+        int runId = -1;
+        std::vector<float> in;
+        std::vector<float> out;
+        int reportedLatencySamples = 0;
+        int alignmentSamples = 0;
+        double sampleRate = 48000.0;
+        std::map<juce::String, float> paramValues;
+        float inputGainDb = 0.0f;
+    };
+
+    RunCapture current;
+    std::vector<juce::String> paramNames;
+    juce::String signalType;
+
+    std::unique_ptr<std::ofstream> csvFile;
+    std::unique_ptr<juce::dsp::FFT> fft;
+    std::vector<float> inScratch;
+    std::vector<float> outScratch;
+
+    void processRun();
+};
+
+std::unique_ptr<Analyzer> createLatencyAnalyzer(const juce::File& outDir, const std::vector<juce::String>& paramNames,
+                                                const juce::String& signalType);
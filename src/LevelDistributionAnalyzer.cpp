@@ -0,0 +1,162 @@
+#include "LevelDistributionAnalyzer.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+LevelDistributionAnalyzer::LevelDistributionAnalyzer(const juce::File& outDir,
+                                                     const std::vector<juce::String>& paramNames,
+                                                     const juce::String& signalType)
+    : paramNames(paramNames), signalType(signalType) {
+    juce::String filename = "grid_level_distribution_" + signalType.toLowerCase() + ".csv";
+    csvFile = std::make_unique<std::ofstream>(outDir.getChildFile(filename).getFullPathName().toStdString());
+    if (!csvFile->is_open()) {
+        std::cerr << "Failed to open " << filename.toStdString() << " for writing" << std::endl;
+        csvFile.reset();
+        return;
+    }
+
+    // Header; histogram columns are named after the lower bin edge in dBFS
+    auto& out = *csvFile;
+    out << "runId,channel,samples,p1,p50,p99,p999,peak";
+    out << ",stRmsP50,stRmsP99,stPeakP50,stPeakP99,stCrestP50,stCrestP99";
+    out << ",hBelow";
+    for (int e = minExponent; e <= maxExponent; ++e)
+        out << ",h" << (int)std::round(20.0 * std::log10(2.0) * (double)e);
+    for (const auto& paramName : paramNames)
+        out << "," << paramName.toStdString();
+    out << ",inputGainDb\n";
+}
+
+LevelDistributionAnalyzer::~LevelDistributionAnalyzer() {}
+
+void LevelDistributionAnalyzer::startRun(const BlockContext& ctx) {
+    current.runId = ctx.runId;
+    current.paramValues = ctx.paramNamedValues;
+    current.inputGainDb = ctx.inputGainDb;
+    current.windowLength = std::max(1, (int)std::round(windowSeconds * ctx.sampleRate));
+
+    current.channelNames.clear();
+    for (int ch = 0; ch < ctx.inputs.numChannels; ++ch)
+        current.channelNames.push_back("in" + ctx.inputs.names[ch]);
+    for (int ch = 0; ch < ctx.outputs.numChannels; ++ch)
+        current.channelNames.push_back("out" + ctx.outputs.names[ch]);
+
+    // Reuse the sketches' storage from the previous run
+    current.channels.resize(current.channelNames.size());
+    for (auto& channel : current.channels) {
+        channel.sampleCount = 0;
+        channel.levels.clear();
+        channel.windowRms.clear();
+        channel.windowPeak.clear();
+        channel.windowCrest.clear();
+        channel.histogram.fill(0);
+        channel.windowSumSq = 0.0;
+        channel.windowPeakLevel = 0.0f;
+        channel.windowPos = 0;
+    }
+}
+
+void LevelDistributionAnalyzer::accumulate(ChannelDistribution& channel, const float* x, int numSamples,
+                                           int windowLength) {
+    const float histogramFloor = std::ldexp(1.0f, minExponent);
+
+    for (int i = 0; i < numSamples; ++i) {
+        const float level = std::abs(x[i]);
+        channel.levels.add(level);
+
+        // frexp gives level = m * 2^e with m in [0.5, 1), i.e. the bin with lower edge 2^(e - 1)
+        int bin = 0;
+        if (level >= histogramFloor) {
+            int e = 0;
+            std::frexp(level, &e);
+            bin = 1 + std::min(e - 1, maxExponent) - minExponent;
+        }
+        channel.histogram[bin]++;
+
+        channel.windowSumSq += (double)level * (double)level;
+        channel.windowPeakLevel = std::max(channel.windowPeakLevel, level);
+        if (++channel.windowPos == windowLength) {
+            const float rms = (float)std::sqrt(channel.windowSumSq / (double)windowLength);
+            channel.windowRms.add(rms);
+            channel.windowPeak.add(channel.windowPeakLevel);
+            if (rms > 0.0f)
+                channel.windowCrest.add(channel.windowPeakLevel / rms);
+
+            channel.windowSumSq = 0.0;
+            channel.windowPeakLevel = 0.0f;
+            channel.windowPos = 0;
+        }
+    }
+
+    channel.sampleCount += numSamples;
+}
+
+void LevelDistributionAnalyzer::processRun() {
+    if (!csvFile)
+        return;
+
+    auto& out = *csvFile;
+    for (size_t ch = 0; ch < current.channels.size(); ++ch) {
+        const auto& channel = current.channels[ch];
+        if (channel.sampleCount == 0)
+            continue;
+
+        out << current.runId << "," << current.channelNames[ch].toStdString() << "," << channel.sampleCount;
+        for (double q : {0.01, 0.5, 0.99, 0.999})
+            out << "," << channel.levels.quantile(q);
+        out << "," << channel.levels.maxValue();
+
+        // Short-term envelopes; empty when the run is shorter than one window
+        for (const auto* sketch : {&channel.windowRms, &channel.windowPeak, &channel.windowCrest}) {
+            if (sketch->count() > 0)
+                out << "," << sketch->quantile(0.5) << "," << sketch->quantile(0.99);
+            else
+                out << ",,";
+        }
+
+        for (int64_t count : channel.histogram)
+            out << "," << count;
+
+        for (const auto& paramName : paramNames) {
+            float value = 0.0f;
+            auto it = current.paramValues.find(paramName);
+            if (it != current.paramValues.end())
+                value = it->second;
+            out << "," << value;
+        }
+        out << "," << current.inputGainDb << "\n";
+    }
+}
+
+void LevelDistributionAnalyzer::processBlock(const BlockContext& ctx) {
+    // A new run id means the previous run is complete
+    if (ctx.runId != current.runId) {
+        if (current.runId >= 0)
+            processRun();
+        startRun(ctx);
+    }
+
+    for (int ch = 0; ch < ctx.inputs.numChannels; ++ch)
+        accumulate(current.channels[ch], ctx.inputs[ch], ctx.numSamples, current.windowLength);
+    for (int ch = 0; ch < ctx.outputs.numChannels; ++ch)
+        accumulate(current.channels[ctx.inputs.numChannels + ch], ctx.outputs[ch], ctx.numSamples,
+                   current.windowLength);
+}
+
+void LevelDistributionAnalyzer::finish(const juce::File& outDir) {
+    if (current.runId >= 0) {
+        processRun();
+        current.runId = -1;
+    }
+
+    if (csvFile) {
+        csvFile->close();
+        csvFile.reset();
+    }
+}
+
+std::unique_ptr<Analyzer> createLevelDistributionAnalyzer(const juce::File& outDir,
+                                                          const std::vector<juce::String>& paramNames,
+                                                          const juce::String& signalType) {
+    return std::make_unique<LevelDistributionAnalyzer>(outDir, paramNames, signalType);
+}
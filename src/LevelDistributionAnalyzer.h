@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Analyzer.h"
+#include "JuceHeader.h"
+#include "QuantileSketch.h"
+#include <array>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <vector>
+
+// Amplitude distribution analyzer. For every channel of the main input and output buses it keeps
+//   - a KLL sketch of |x| for the p1 / p50 / p99 / p99.9 sample levels,
+//   - short-term (50 ms) RMS, peak and crest-factor envelopes, themselves summarised by sketches,
+//   - a histogram of |x| in one-octave (6.02 dB) bins from -144 dBFS to +12 dBFS.
+// All of it is fixed-size, so memory does not depend on run length. Rows are written as soon as the next
+// run starts, one per run and channel.
+struct LevelDistributionAnalyzer : public Analyzer {
+    static constexpr int minExponent = -24;                                // lowest bin edge 2^-24 (-144.5 dBFS)
+    static constexpr int maxExponent = 1;                                  // top bin [2^1, inf) (+6 dBFS and above)
+    static constexpr int numHistogramBins = maxExponent - minExponent + 2; // plus one bin below the range
+    static constexpr double windowSeconds = 0.05;
+
+    LevelDistributionAnalyzer(const juce::File& outDir, const std::vector<juce::String>& paramNames,
+                              const juce::String& signalType);
+    ~LevelDistributionAnalyzer() override;
+
+    void processBlock(const BlockContext& ctx) override;
+    void finish(const juce::File& outDir) override;
+
+private:
+    struct ChannelDistribution {
+        int64_t sampleCount = 0;
+        QuantileSketch levels;
+        QuantileSketch windowRms;
+        QuantileSketch windowPeak;
+        QuantileSketch windowCrest;
+        std::array<int64_t, numHistogramBins> histogram{};
+
+        // Short-term window in progress
+        double windowSumSq = 0.0;
+        float windowPeakLevel = 0.0f;
+        int windowPos = 0;
+    };
+
+    struct RunCapture {
+        int runId = -1;
+        int windowLength = 0;
+        std::vector<ChannelDistribution> channels; // main inputs, then main outputs
+        std::vector<juce::String> channelNames;    // "inL", "inR", "outL", "outC"...
+        std::map<juce::String, float> paramValues;
+        float inputGainDb = 0.0f;
+    };
+
+    RunCapture current;
+    std::vector<juce::String> paramNames;
+    juce::String signalType;
+
+    std::unique_ptr<std::ofstream> csvFile;
+
+    void startRun(const BlockContext& ctx);
+    void accumulate(ChannelDistribution& channel, const float* x, int numSamples, int windowLength);
+    void processRun();
+};
+
+std::unique_ptr<Analyzer> createLevelDistributionAnalyzer(const juce::File& outDir,
+                                                          const std::vector<juce::String>& paramNames,
+                                                          const juce::String& signalType);
@@ -1,65 +1,71 @@
 #include "LinearResponseAnalyzer.h"
 #include "JuceHeader.h"
+#include <algorithm>
 #include <cmath>
 #include <fstream>
 #include <iostream>
+#include <limits>
 
-LinearResponseAnalyzer::LinearResponseAnalyzer(const juce::File& outDir, int fftSize,
+// Equivalent noise bandwidth of the Hann window, in bins
+static constexpr double hannNoiseBandwidthBins = 1.5;
+
+LinearResponseAnalyzer::LinearResponseAnalyzer(const juce::File& outDir, int fftSize, double overlap, int smoothing,
+                                               int numPoints, bool envelope,
                                                const std::vector<juce::String>& paramNames,
                                                const juce::String& signalType)
-    : fftSize(fftSize), paramNames(paramNames), outputDir(outDir), signalType(signalType) {}
-
-LinearResponseAnalyzer::~LinearResponseAnalyzer() {}
+    : fftSize(fftSize), smoothing(std::max(0, smoothing)), numPoints(std::max(0, numPoints)), envelope(envelope),
+      paramNames(paramNames), outputDir(outDir), signalType(signalType), fft((int)std::log2(fftSize)) {
+    overlap = std::clamp(overlap, 0.0, 0.875);
+    hopSize = std::max(1, (int)std::round((double)fftSize * (1.0 - overlap)));
 
-void LinearResponseAnalyzer::applyHannWindow(std::vector<float>& buffer) {
-    const int N = (int)buffer.size();
-    for (int i = 0; i < N; ++i) {
-        float window = 0.5f * (1.0f - std::cos(2.0f * juce::MathConstants<float>::pi * (float)i / (float)(N - 1)));
-        buffer[i] *= window;
+    // Periodic Hann: overlapped segments at 50% / 75% sum to a constant
+    window.resize(fftSize);
+    for (int i = 0; i < fftSize; ++i) {
+        window[i] = 0.5f * (1.0f - std::cos(2.0f * juce::MathConstants<float>::pi * (float)i / (float)fftSize));
     }
+
+    inScratch.resize(2 * fftSize);
+    outScratch.resize(2 * fftSize);
 }
 
+LinearResponseAnalyzer::~LinearResponseAnalyzer() {}
+
 void LinearResponseAnalyzer::processFFTWindow(RunSpectrum& spectrum) {
     if ((int)spectrum.inBuffer.size() < fftSize || (int)spectrum.outBuffer.size() < fftSize)
         return;
 
-    // Apply window
-    applyHannWindow(spectrum.inBuffer);
-    applyHannWindow(spectrum.outBuffer);
-
-    // Perform FFT
-    juce::dsp::FFT fft((int)std::log2(fftSize));
-    std::vector<std::complex<float>> inFFT(fftSize);
-    std::vector<std::complex<float>> outFFT(fftSize);
-
-    // Copy to complex buffers
+    // Apply window into the FFT workspace (leaves the sample buffers intact for overlap)
+    std::fill(inScratch.begin(), inScratch.end(), 0.0f);
+    std::fill(outScratch.begin(), outScratch.end(), 0.0f);
     for (int i = 0; i < fftSize; ++i) {
-        inFFT[i] = std::complex<float>(spectrum.inBuffer[i], 0.0f);
-        outFFT[i] = std::complex<float>(spectrum.outBuffer[i], 0.0f);
+        inScratch[i] = spectrum.inBuffer[i] * window[i];
+        outScratch[i] = spectrum.outBuffer[i] * window[i];
     }
 
-    // Perform FFT
-    fft.perform(inFFT.data(), outFFT.data(), false);
+    fft.performRealOnlyForwardTransform(inScratch.data(), true);
+    fft.performRealOnlyForwardTransform(outScratch.data(), true);
 
-    // Accumulate magnitude squared
+    // Accumulate auto and cross spectra
     const int numBins = fftSize / 2;
     if ((int)spectrum.sumInMagSq.size() < numBins) {
         spectrum.sumInMagSq.resize(numBins, 0.0);
         spectrum.sumOutMagSq.resize(numBins, 0.0);
+        spectrum.sumCrossSpec.resize(numBins, {0.0, 0.0});
     }
 
     for (int k = 0; k < numBins; ++k) {
-        float inMag = std::abs(inFFT[k]);
-        float outMag = std::abs(outFFT[k]);
-        spectrum.sumInMagSq[k] += (double)(inMag * inMag);
-        spectrum.sumOutMagSq[k] += (double)(outMag * outMag);
+        const std::complex<double> X(inScratch[2 * k], inScratch[2 * k + 1]);
+        const std::complex<double> Y(outScratch[2 * k], outScratch[2 * k + 1]);
+        spectrum.sumInMagSq[k] += std::norm(X);
+        spectrum.sumOutMagSq[k] += std::norm(Y);
+        spectrum.sumCrossSpec[k] += std::conj(X) * Y;
     }
 
     spectrum.numAverages++;
 
-    // Clear buffers for next window
-    spectrum.inBuffer.clear();
-    spectrum.outBuffer.clear();
+    // Slide by one hop, keeping the overlapping tail for the next segment
+    spectrum.inBuffer.erase(spectrum.inBuffer.begin(), spectrum.inBuffer.begin() + hopSize);
+    spectrum.outBuffer.erase(spectrum.outBuffer.begin(), spectrum.outBuffer.begin() + hopSize);
 }
 
 void LinearResponseAnalyzer::processBlock(const BlockContext& ctx) {
@@ -70,14 +76,19 @@ void LinearResponseAnalyzer::processBlock(const BlockContext& ctx) {
         spectrum.paramValues = ctx.paramNamedValues;
         spectrum.inputGainDb = ctx.inputGainDb;
         spectrum.sampleRate = ctx.sampleRate;
+        spectrum.inBuffer.reserve(fftSize);
+        spectrum.outBuffer.reserve(fftSize);
     }
 
-    // Accumulate samples
-    for (int i = 0; i < ctx.numSamples; ++i) {
-        spectrum.inBuffer.push_back(ctx.inL[i]);
-        spectrum.outBuffer.push_back(ctx.outL[i]);
+    // Accumulate samples, processing a segment whenever the buffer fills
+    int i = 0;
+    while (i < ctx.numSamples) {
+        const int needed = fftSize - (int)spectrum.inBuffer.size();
+        const int toCopy = std::min(needed, ctx.numSamples - i);
+        spectrum.inBuffer.insert(spectrum.inBuffer.end(), ctx.inL + i, ctx.inL + i + toCopy);
+        spectrum.outBuffer.insert(spectrum.outBuffer.end(), ctx.outL + i, ctx.outL + i + toCopy);
+        i += toCopy;
 
-        // Process FFT window when we have enough samples
         if ((int)spectrum.inBuffer.size() >= fftSize) {
             processFFTWindow(spectrum);
         }
@@ -95,32 +106,143 @@ void LinearResponseAnalyzer::finish(const juce::File& outDir) {
     }
 
     // Header
-    out << "runId,freqHz,magDb";
+    out << "runId,freqHz,magDb,phaseDeg,groupDelayMs,coherence,h2MagDb,magErrDb,numAverages";
+    if (envelope)
+        out << ",magMinDb,magMaxDb";
     for (const auto& paramName : paramNames) {
         out << "," << paramName.toStdString();
     }
     out << ",inputGainDb\n";
 
+    const double twoPi = 2.0 * juce::MathConstants<double>::pi;
+    const int numBins = fftSize / 2;
+
+    // Bin ranges [first, last] behind each output frequency. Without reduction every bin is its own point.
+    // Otherwise each point covers 1/N octave, or without smoothing the span to its neighbours, and falls back
+    // to the nearest bin where that span holds none (low frequencies, where bins are sparse).
+    struct Band {
+        double freqHz;
+        int first, last;
+    };
+    auto makeBands = [&](double binHz) {
+        std::vector<Band> bands;
+        if (smoothing == 0 && numPoints == 0) {
+            for (int k = 0; k < numBins; ++k)
+                bands.push_back({(double)k * binHz, k, k});
+            return bands;
+        }
+
+        std::vector<double> centres;
+        if (numPoints > 0) {
+            const double lowHz = binHz;
+            const double highHz = (double)(numBins - 1) * binHz;
+            for (int i = 0; i < numPoints; ++i) {
+                const double t = numPoints > 1 ? (double)i / (double)(numPoints - 1) : 0.0;
+                centres.push_back(lowHz * std::pow(highHz / lowHz, t));
+            }
+        } else {
+            for (int k = 1; k < numBins; ++k)
+                centres.push_back((double)k * binHz);
+        }
+
+        double halfWidthOctaves = smoothing > 0 ? 0.5 / (double)smoothing : 0.0;
+        if (smoothing == 0 && centres.size() > 1)
+            halfWidthOctaves = 0.5 * std::log2(centres[1] / centres[0]);
+
+        for (double centre : centres) {
+            const double ratio = std::pow(2.0, halfWidthOctaves);
+            int first = std::max(1, (int)std::ceil(centre / ratio / binHz - 1e-9));
+            int last = std::min(numBins - 1, (int)std::floor(centre * ratio / binHz + 1e-9));
+            double freqHz = centre;
+            if (first > last) {
+                first = last = juce::jlimit(1, numBins - 1, (int)std::lround(centre / binHz));
+                freqHz = (double)first * binHz;
+            }
+            // Neighbouring points on the same bins would repeat a row
+            if (!bands.empty() && bands.back().first == first && bands.back().last == last)
+                continue;
+            bands.push_back({freqHz, first, last});
+        }
+        return bands;
+    };
+
     // Data rows
     for (const auto& [runId, spectrum] : perRunSpectra) {
         if (spectrum.numAverages == 0)
             continue;
 
-        const int numBins = fftSize / 2;
         const double binHz = spectrum.sampleRate / (double)fftSize;
 
+        // H1 per bin (zero where the input carried no energy)
+        std::vector<std::complex<double>> H1(numBins, {0.0, 0.0});
         for (int k = 0; k < numBins; ++k) {
-            double magIn = std::sqrt(spectrum.sumInMagSq[k] / spectrum.numAverages);
-            double magOut = std::sqrt(spectrum.sumOutMagSq[k] / spectrum.numAverages);
+            if (spectrum.sumInMagSq[k] > 0.0)
+                H1[k] = spectrum.sumCrossSpec[k] / spectrum.sumInMagSq[k];
+        }
+
+        // Group delay -dphi/domega per bin, from the wrapped phase difference of neighbouring bins
+        std::vector<double> groupDelayMs(numBins, 0.0);
+        for (int k = 0; k < numBins; ++k) {
+            const int kLo = std::max(0, k - 1);
+            const int kHi = std::min(numBins - 1, k + 1);
+            if (kHi > kLo) {
+                const double dPhi = std::arg(H1[kHi] * std::conj(H1[kLo]));
+                const double dOmega = twoPi * binHz * (double)(kHi - kLo);
+                groupDelayMs[k] = -dPhi / dOmega * 1000.0;
+            }
+        }
+
+        for (const auto& band : makeBands(binHz)) {
+            // Spectra are averaged over the band before the estimates are formed; group delay and the envelope
+            // come from the bins that carried input
+            double Sxx = 0.0, Syy = 0.0, groupDelaySum = 0.0;
+            std::complex<double> Sxy(0.0, 0.0);
+            double minMag = std::numeric_limits<double>::max(), maxMag = 0.0;
+            int numValid = 0;
+            for (int k = band.first; k <= band.last; ++k) {
+                if (spectrum.sumInMagSq[k] <= 0.0)
+                    continue;
+                Sxx += spectrum.sumInMagSq[k];
+                Syy += spectrum.sumOutMagSq[k];
+                Sxy += spectrum.sumCrossSpec[k];
+                groupDelaySum += groupDelayMs[k];
+                minMag = std::min(minMag, std::abs(H1[k]));
+                maxMag = std::max(maxMag, std::abs(H1[k]));
+                ++numValid;
+            }
 
-            if (magIn <= 0.0)
+            if (numValid == 0)
                 continue;
 
-            double H = magOut / magIn;
-            double magDb = 20.0 * std::log10(std::max(H, 1e-10));
-            double freqHz = (double)k * binHz;
+            const std::complex<double> H = Sxy / Sxx;
+            const double magDb = 20.0 * std::log10(std::max(std::abs(H), 1e-10));
+            const double phaseDeg = std::arg(H) * 180.0 / juce::MathConstants<double>::pi;
+
+            const double crossMagSq = std::norm(Sxy);
+            const double coherence = (Syy > 0.0) ? std::clamp(crossMagSq / (Sxx * Syy), 0.0, 1.0) : 0.0;
 
-            out << runId << "," << freqHz << "," << magDb;
+            // H2 = Syy / Syx, |Syx| = |Sxy|
+            const double h2 = crossMagSq > 0.0 ? Syy / std::sqrt(crossMagSq) : 0.0;
+            const double h2MagDb = 20.0 * std::log10(std::max(h2, 1e-10));
+
+            // Normalised random error of |H1| (Bendat & Piersol): sqrt(1 - g^2) / (|g| sqrt(2 nd)). Averaging
+            // over the band's bins adds to the averages already taken over time, but neighbouring Hann bins are
+            // correlated, so the band counts as numValid / 1.5 (the window's noise bandwidth in bins) averages.
+            double magErrDb = 0.0;
+            if (coherence > 0.0) {
+                const double independentBins = std::max(1.0, (double)numValid / hannNoiseBandwidthBins);
+                const double nd = (double)spectrum.numAverages * independentBins;
+                const double eps = std::sqrt(1.0 - coherence) / (std::sqrt(coherence) * std::sqrt(2.0 * nd));
+                magErrDb = 20.0 * std::log10(1.0 + eps);
+            }
+
+            out << runId << "," << band.freqHz << "," << magDb << "," << phaseDeg << ","
+                << groupDelaySum / (double)numValid << "," << coherence << "," << h2MagDb << "," << magErrDb << ","
+                << spectrum.numAverages;
+            if (envelope) {
+                out << "," << 20.0 * std::log10(std::max(minMag, 1e-10)) << ","
+                    << 20.0 * std::log10(std::max(maxMag, 1e-10));
+            }
 
             // Parameter values
             for (const auto& paramName : paramNames) {
@@ -136,8 +258,10 @@ void LinearResponseAnalyzer::finish(const juce::File& outDir) {
     }
 }
 
-std::unique_ptr<Analyzer> createLinearResponseAnalyzer(const juce::File& outDir, int fftSize,
+std::unique_ptr<Analyzer> createLinearResponseAnalyzer(const juce::File& outDir, int fftSize, double overlap,
+                                                       int smoothing, int numPoints, bool envelope,
                                                        const std::vector<juce::String>& paramNames,
                                                        const juce::String& signalType) {
-    return std::make_unique<LinearResponseAnalyzer>(outDir, fftSize, paramNames, signalType);
+    return std::make_unique<LinearResponseAnalyzer>(outDir, fftSize, overlap, smoothing, numPoints, envelope,
+                                                    paramNames, signalType);
 }
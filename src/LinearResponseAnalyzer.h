@@ -6,8 +6,21 @@
 #include <map>
 #include <vector>
 
+// Welch-averaged cross-spectral transfer function estimator.
+// Hann-windowed segments overlap by `overlap` (0 = none, 0.5 / 0.75 typical) and are averaged into
+// auto spectra Sxx, Syy and the cross spectrum Sxy. Per bin we report H1 = Sxy / Sxx (unbiased by
+// output noise), H2 = Syy / Syx (unbiased by input noise), phase, group delay and the
+// magnitude-squared coherence, plus a coherence-based random error estimate for |H1| (counting the bins
+// of a smoothed or reduced row as bins / 1.5 averages, since neighbouring Hann bins are correlated).
+//
+// Output can be reduced before it is written. `smoothing` = N averages the spectra over 1/N octave around each
+// frequency (complex smoothing of Sxy, so phase survives). `numPoints` > 0 writes that many log-spaced
+// frequencies from the first bin to Nyquist instead of every bin; without smoothing each point averages the bins
+// up to its neighbours. `envelope` adds the min/max |H1| of the bins behind each point, so narrow notches and
+// peaks stay visible after smoothing.
 struct LinearResponseAnalyzer : public Analyzer {
-    LinearResponseAnalyzer(const juce::File& outDir, int fftSize, const std::vector<juce::String>& paramNames,
+    LinearResponseAnalyzer(const juce::File& outDir, int fftSize, double overlap, int smoothing, int numPoints,
+                           bool envelope, const std::vector<juce::String>& paramNames,
                            const juce::String& signalType);
     ~LinearResponseAnalyzer() override;
 
@@ -16,8 +29,9 @@ struct LinearResponseAnalyzer : public Analyzer {
 
 private:
     struct RunSpectrum {
-        std::vector<double> sumInMagSq;
-        std::vector<double> sumOutMagSq;
+        std::vector<double> sumInMagSq;                 // Sxx
+        std::vector<double> sumOutMagSq;                // Syy
+        std::vector<std::complex<double>> sumCrossSpec; // Sxy = conj(X) * Y
         int numAverages = 0;
         std::vector<float> inBuffer;
         std::vector<float> outBuffer;
@@ -28,14 +42,23 @@ private:
 
     std::map<int, RunSpectrum> perRunSpectra;
     int fftSize;
+    int hopSize;
+    int smoothing; // 1/N octave, 0 = none
+    int numPoints; // 0 = every bin
+    bool envelope;
     std::vector<juce::String> paramNames;
     juce::File outputDir;
     juce::String signalType;
 
+    juce::dsp::FFT fft;
+    std::vector<float> window;
+    std::vector<float> inScratch;  // 2 * fftSize, real-only FFT workspace
+    std::vector<float> outScratch; // 2 * fftSize, real-only FFT workspace
+
     void processFFTWindow(RunSpectrum& spectrum);
-    void applyHannWindow(std::vector<float>& buffer);
 };
 
-std::unique_ptr<Analyzer> createLinearResponseAnalyzer(const juce::File& outDir, int fftSize,
+std::unique_ptr<Analyzer> createLinearResponseAnalyzer(const juce::File& outDir, int fftSize, double overlap,
+                                                       int smoothing, int numPoints, bool envelope,
                                                        const std::vector<juce::String>& paramNames,
                                                        const juce::String& signalType);
@@ -0,0 +1,103 @@
+#include "LinearityCheck.h"
+#include "SignalGenerator.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// Runs `input * gain` through a freshly reset plugin, in SampleType, on every main input channel (other input
+// buses stay silent); output holds the main output channels one after the other
+template <typename SampleType>
+static void processProbe(juce::AudioPluginInstance& plugin, int blockSize, const std::vector<float>& input, float gain,
+                         std::vector<float>& output) {
+    const int64_t length = (int64_t)input.size();
+    const int numInputs = plugin.getMainBusNumInputChannels();
+    const int numOutputs = std::max(1, plugin.getMainBusNumOutputChannels());
+    const int numChannels =
+        std::max({numOutputs, plugin.getTotalNumInputChannels(), plugin.getTotalNumOutputChannels()});
+    output.assign((size_t)numOutputs * input.size(), 0.0f);
+
+    juce::AudioBuffer<SampleType> buffer(numChannels, blockSize);
+    juce::MidiBuffer midiBuffer;
+    plugin.reset();
+
+    for (int64_t start = 0; start < length; start += blockSize) {
+        const int numThisBlock = (int)std::min<int64_t>(blockSize, length - start);
+        buffer.clear();
+        for (int ch = 0; ch < numInputs; ++ch) {
+            auto* data = buffer.getWritePointer(ch);
+            for (int i = 0; i < numThisBlock; ++i)
+                data[i] = (SampleType)gain * (SampleType)input[start + i];
+        }
+
+        juce::AudioBuffer<SampleType> pluginBlock(buffer.getArrayOfWritePointers(), numChannels, numThisBlock);
+        plugin.processBlock(pluginBlock, midiBuffer);
+
+        for (int ch = 0; ch < numOutputs; ++ch)
+            std::copy(buffer.getReadPointer(ch), buffer.getReadPointer(ch) + numThisBlock,
+                      output.begin() + ch * length + start);
+    }
+}
+
+// Energy of (test - reference) relative to the reference, in dB
+static double residualDb(const std::vector<float>& reference, const std::vector<float>& test) {
+    double referenceEnergy = 0.0, residualEnergy = 0.0;
+    for (size_t i = 0; i < reference.size(); ++i) {
+        const double diff = (double)test[i] - (double)reference[i];
+        referenceEnergy += (double)reference[i] * (double)reference[i];
+        residualEnergy += diff * diff;
+    }
+    if (residualEnergy <= 0.0)
+        return -300.0;
+    if (referenceEnergy <= 0.0)
+        return 0.0;
+    return 10.0 * std::log10(residualEnergy / referenceEnergy);
+}
+
+LinearityResult checkLinearity(juce::AudioPluginInstance& plugin, int blockSize, int64_t probeSamples,
+                               float lowGainDb, float highGainDb, double toleranceDb, uint64_t seed) {
+    const int length = (int)std::max<int64_t>(1, probeSamples);
+    auto renderNoise = [&](int stream) {
+        NoiseGenerator noise;
+        noise.amplitude = 1.0f;
+        noise.seed = deriveRunSeed(seed, stream);
+        noise.reset();
+        juce::AudioBuffer<float> buffer(1, length);
+        noise.fillBlock(buffer, length);
+        return std::vector<float>(buffer.getReadPointer(0), buffer.getReadPointer(0) + length);
+    };
+
+    const std::vector<float> u = renderNoise(0);
+    const std::vector<float> v = renderNoise(1);
+    std::vector<float> uv(length);
+    for (int i = 0; i < length; ++i)
+        uv[i] = u[i] + v[i];
+
+    const float low = std::pow(10.0f, lowGainDb / 20.0f);
+    const float high = std::pow(10.0f, highGainDb / 20.0f);
+    const float half = 0.5f * high;
+
+    // The probe processes in whichever precision the plugin is prepared for
+    auto probe = plugin.isUsingDoublePrecision() ? processProbe<double> : processProbe<float>;
+    std::vector<float> yLow, yHigh, yV, yUV;
+    probe(plugin, blockSize, u, low, yLow);
+    probe(plugin, blockSize, u, high, yHigh);
+    probe(plugin, blockSize, v, half, yV);
+    probe(plugin, blockSize, uv, half, yUV);
+    plugin.reset();
+
+    LinearityResult result;
+
+    // Homogeneity: the low-level response scaled up should match the high-level one
+    std::vector<float> expected(yLow.size());
+    for (size_t i = 0; i < yLow.size(); ++i)
+        expected[i] = (high / low) * yLow[i];
+    result.homogeneityErrorDb = residualDb(yHigh, expected);
+
+    // Superposition: the response to the sum should be the sum of the responses
+    for (size_t i = 0; i < yUV.size(); ++i)
+        expected[i] = 0.5f * yHigh[i] + yV[i];
+    result.superpositionErrorDb = residualDb(yUV, expected);
+
+    result.linear = result.homogeneityErrorDb <= toleranceDb && result.superpositionErrorDb <= toleranceDb;
+    return result;
+}
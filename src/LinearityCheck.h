@@ -0,0 +1,18 @@
+#pragma once
+
+#include "JuceHeader.h"
+#include <cstdint>
+
+struct LinearityResult {
+    double homogeneityErrorDb = 0.0;   // P(b*u) against (b/a) * P(a*u)
+    double superpositionErrorDb = 0.0; // P(c*(u + v)) against P(c*u) + P(c*v)
+    bool linear = false;
+};
+
+// Short noise probe of the plugin's current settings for linearity across an input level range. Four
+// passes, each from a reset plugin: unit noise u at the lowest and highest level, a second noise v at half
+// the highest level, and u + v at half the highest level. Each error is the residual energy relative to the
+// reference output in dB; the setting counts as linear when both are at or below toleranceDb. The probe is
+// processed in the precision the plugin is prepared for.
+LinearityResult checkLinearity(juce::AudioPluginInstance& plugin, int blockSize, int64_t probeSamples,
+                               float lowGainDb, float highGainDb, double toleranceDb, uint64_t seed);
@@ -0,0 +1,361 @@
+#include "LoudnessAnalyzer.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+// BS.1770-4 Annex 2 true-peak interpolator: 48 taps, as 4 phases of 12
+static const float truePeakCoefficients[LoudnessAnalyzer::truePeakPhases][LoudnessAnalyzer::truePeakTaps] = {
+    {0.0017089843750f, 0.0109863281250f, -0.0196533203125f, 0.0332031250000f, -0.0594482421875f, 0.1373291015625f,
+     0.9721679687500f, -0.1022949218750f, 0.0476074218750f, -0.0266113281250f, 0.0148925781250f, -0.0083007812500f},
+    {-0.0291748046875f, 0.0292968750000f, -0.0517578125000f, 0.0891113281250f, -0.1665039062500f, 0.4650878906250f,
+     0.7797851562500f, -0.2003173828125f, 0.1015625000000f, -0.0582275390625f, 0.0330810546875f, -0.0189208984375f},
+    {-0.0189208984375f, 0.0330810546875f, -0.0582275390625f, 0.1015625000000f, -0.2003173828125f, 0.7797851562500f,
+     0.4650878906250f, -0.1665039062500f, 0.0891113281250f, -0.0517578125000f, 0.0292968750000f, -0.0291748046875f},
+    {-0.0083007812500f, 0.0148925781250f, -0.0266113281250f, 0.0476074218750f, -0.1022949218750f, 0.9721679687500f,
+     0.1373291015625f, -0.0594482421875f, 0.0332031250000f, -0.0196533203125f, 0.0109863281250f, 0.0017089843750f}};
+
+static double powerToLufs(double power) {
+    return -0.691 + 10.0 * std::log10(power);
+}
+
+// BS.1770 channel weight G from the channel's layout name: 1.41 for the side surrounds (azimuth 60 to 120
+// degrees), LFE excluded, the rest (rear surrounds included) 1
+static double channelWeight(const juce::String& name) {
+    if (name.startsWithIgnoreCase("Lfe"))
+        return 0.0;
+    for (const char* surround : {"Ls", "Rs", "Lss", "Rss"}) {
+        if (name.equalsIgnoreCase(surround))
+            return 1.41;
+    }
+    return 1.0;
+}
+
+void LoudnessAnalyzer::LoudnessHistogram::clear() {
+    count.fill(0);
+    power.fill(0.0);
+}
+
+void LoudnessAnalyzer::LoudnessHistogram::add(double blockPower) {
+    if (!(blockPower > 0.0))
+        return;
+    const double lufs = powerToLufs(blockPower);
+    if (lufs < absoluteGateLufs)
+        return;
+    const int bin = std::min(numHistogramBins - 1, (int)((lufs - absoluteGateLufs) / histogramStepLu));
+    count[bin]++;
+    power[bin] += blockPower;
+}
+
+// First bin at or above the relative gate, which sits relativeGateLu below the power mean of every block
+// that passed the absolute gate; numHistogramBins if there are none
+static int relativeGateBin(const std::array<int64_t, LoudnessAnalyzer::numHistogramBins>& count,
+                           const std::array<double, LoudnessAnalyzer::numHistogramBins>& power,
+                           double relativeGateLu) {
+    int64_t totalCount = 0;
+    double totalPower = 0.0;
+    for (int bin = 0; bin < LoudnessAnalyzer::numHistogramBins; ++bin) {
+        totalCount += count[bin];
+        totalPower += power[bin];
+    }
+    if (totalCount == 0)
+        return LoudnessAnalyzer::numHistogramBins;
+
+    const double gateLufs = powerToLufs(totalPower / (double)totalCount) + relativeGateLu;
+    const double position = (gateLufs - LoudnessAnalyzer::absoluteGateLufs) / LoudnessAnalyzer::histogramStepLu;
+    return std::clamp((int)std::floor(position), 0, LoudnessAnalyzer::numHistogramBins - 1);
+}
+
+double LoudnessAnalyzer::LoudnessHistogram::gatedLoudness(double relativeGateLu) const {
+    int64_t gatedCount = 0;
+    double gatedPower = 0.0;
+    for (int bin = relativeGateBin(count, power, relativeGateLu); bin < numHistogramBins; ++bin) {
+        gatedCount += count[bin];
+        gatedPower += power[bin];
+    }
+    if (gatedCount == 0)
+        return std::numeric_limits<double>::quiet_NaN();
+    return powerToLufs(gatedPower / (double)gatedCount);
+}
+
+double LoudnessAnalyzer::LoudnessHistogram::range(double relativeGateLu) const {
+    const int firstBin = relativeGateBin(count, power, relativeGateLu);
+    int64_t gatedCount = 0;
+    for (int bin = firstBin; bin < numHistogramBins; ++bin)
+        gatedCount += count[bin];
+    if (gatedCount == 0)
+        return std::numeric_limits<double>::quiet_NaN();
+
+    // Nearest-rank percentiles, read as the centre of the bin they fall in
+    auto percentile = [&](double q) {
+        const int64_t rank = (int64_t)std::llround(q * (double)(gatedCount - 1));
+        int64_t seen = 0;
+        int bin = firstBin;
+        for (; bin < numHistogramBins - 1; ++bin) {
+            seen += count[bin];
+            if (seen > rank)
+                break;
+        }
+        return absoluteGateLufs + ((double)bin + 0.5) * histogramStepLu;
+    };
+    return percentile(0.95) - percentile(0.10);
+}
+
+LoudnessAnalyzer::LoudnessAnalyzer(const juce::File& outDir, const std::vector<juce::String>& paramNames,
+                                   const juce::String& signalType)
+    : paramNames(paramNames), signalType(signalType) {
+    for (const auto& phase : truePeakCoefficients) {
+        float gain = 0.0f;
+        for (float c : phase)
+            gain += std::abs(c);
+        truePeakGain = std::max(truePeakGain, gain);
+    }
+
+    juce::String filename = "grid_loudness_" + signalType.toLowerCase() + ".csv";
+    csvFile = std::make_unique<std::ofstream>(outDir.getChildFile(filename).getFullPathName().toStdString());
+    if (!csvFile->is_open()) {
+        std::cerr << "Failed to open " << filename.toStdString() << " for writing" << std::endl;
+        csvFile.reset();
+        return;
+    }
+
+    // Header
+    *csvFile << "runId";
+    for (const char* bus : {"in", "out"}) {
+        for (const char* metric :
+             {"IntegratedLufs", "MomentaryMaxLufs", "ShortTermMaxLufs", "LoudnessRangeLu", "TruePeakDbtp"})
+            *csvFile << "," << bus << metric;
+    }
+    for (const auto& paramName : paramNames)
+        *csvFile << "," << paramName.toStdString();
+    *csvFile << ",inputGainDb\n";
+}
+
+LoudnessAnalyzer::~LoudnessAnalyzer() {}
+
+void LoudnessAnalyzer::startBus(BusLoudness& bus, const ChannelView<float>& view) {
+    bus.channels.assign(view.numChannels, ChannelState());
+    for (int ch = 0; ch < view.numChannels; ++ch)
+        bus.channels[ch].weight = channelWeight(view.names[ch]);
+    bus.subBlockPower = 0.0;
+    bus.subBlockPos = 0;
+    bus.subBlocks.fill(0.0);
+    bus.numSubBlocks = 0;
+    bus.maxMomentaryPower = -1.0;
+    bus.maxShortTermPower = -1.0;
+    bus.momentary.clear();
+    bus.shortTerm.clear();
+    bus.truePeak = 0.0f;
+}
+
+void LoudnessAnalyzer::completeSubBlock(BusLoudness& bus) {
+    const int ringSize = (int)bus.subBlocks.size();
+    bus.subBlocks[bus.numSubBlocks % ringSize] = bus.subBlockPower / (double)current.subBlockLength;
+    bus.numSubBlocks++;
+    bus.subBlockPower = 0.0;
+    bus.subBlockPos = 0;
+
+    // Mean power of the last n 100 ms steps
+    auto windowPower = [&](int n) {
+        double sum = 0.0;
+        for (int i = 1; i <= n; ++i)
+            sum += bus.subBlocks[(bus.numSubBlocks - i) % ringSize];
+        return sum / (double)n;
+    };
+
+    if (bus.numSubBlocks >= 4) {
+        const double momentary = windowPower(4);
+        bus.maxMomentaryPower = std::max(bus.maxMomentaryPower, momentary);
+        bus.momentary.add(momentary);
+    }
+    if (bus.numSubBlocks >= ringSize) {
+        const double shortTerm = windowPower(ringSize);
+        bus.maxShortTermPower = std::max(bus.maxShortTermPower, shortTerm);
+        bus.shortTerm.add(shortTerm);
+    }
+}
+
+void LoudnessAnalyzer::processTruePeak(ChannelState& channel, float& truePeak, const float* x,
+                                       int numSamples) const {
+    constexpr int history = truePeakTaps - 1;
+    auto& samples = channel.samples;
+
+    for (int start = 0; start < numSamples; start += truePeakChunk) {
+        const int n = std::min(truePeakChunk, numSamples - start);
+        std::copy(x + start, x + start + n, samples.begin() + history);
+
+        float inputPeak = 0.0f;
+        for (int i = 0; i < history + n; ++i)
+            inputPeak = std::max(inputPeak, std::abs(samples[i]));
+        for (int i = 0; i < n; ++i)
+            truePeak = std::max(truePeak, std::abs(x[start + i]));
+
+        // Interpolate unless no output of this chunk could exceed the true peak so far. The running maximum is
+        // kept per sample and reduced once per chunk, so every inner loop vectorises.
+        if (inputPeak * truePeakGain > truePeak) {
+            float acc[truePeakChunk];
+            float peaks[truePeakChunk] = {};
+            for (const auto& phase : truePeakCoefficients) {
+                std::fill(acc, acc + n, 0.0f);
+                for (int k = 0; k < truePeakTaps; ++k) {
+                    const float c = phase[k];
+                    const float* in = samples.data() + history - k;
+                    for (int i = 0; i < n; ++i)
+                        acc[i] += c * in[i];
+                }
+                for (int i = 0; i < n; ++i)
+                    peaks[i] = std::max(peaks[i], std::abs(acc[i]));
+            }
+            truePeak = std::max(truePeak, *std::max_element(peaks, peaks + n));
+        }
+
+        std::copy(samples.begin() + n, samples.begin() + n + history, samples.begin());
+    }
+}
+
+void LoudnessAnalyzer::accumulate(BusLoudness& bus, const ChannelView<float>& view, int start, int numSamples) {
+    const auto& shelf = current.shelf;
+    const auto& highPass = current.highPass;
+    const int numChannels = std::min(view.numChannels, (int)bus.channels.size());
+
+    // Split at the 100 ms step boundaries
+    int offset = 0;
+    while (offset < numSamples) {
+        const int n = std::min(numSamples - offset, current.subBlockLength - bus.subBlockPos);
+
+        for (int ch = 0; ch < numChannels; ++ch) {
+            auto& channel = bus.channels[ch];
+            if (channel.weight == 0.0)
+                continue;
+
+            const float* x = view[ch] + start + offset;
+            double z0 = channel.z[0], z1 = channel.z[1], z2 = channel.z[2], z3 = channel.z[3];
+            double sumSq = 0.0;
+            for (int i = 0; i < n; ++i) {
+                // Pre-filter (high shelf), then the RLB high-pass
+                const double in = (double)x[i];
+                const double s = shelf.b0 * in + z0;
+                z0 = shelf.b1 * in - shelf.a1 * s + z1;
+                z1 = shelf.b2 * in - shelf.a2 * s;
+                const double y = highPass.b0 * s + z2;
+                z2 = highPass.b1 * s - highPass.a1 * y + z3;
+                z3 = highPass.b2 * s - highPass.a2 * y;
+                sumSq += y * y;
+            }
+            channel.z[0] = z0;
+            channel.z[1] = z1;
+            channel.z[2] = z2;
+            channel.z[3] = z3;
+            bus.subBlockPower += channel.weight * sumSq;
+        }
+
+        offset += n;
+        bus.subBlockPos += n;
+        if (bus.subBlockPos == current.subBlockLength)
+            completeSubBlock(bus);
+    }
+
+    // True peak covers every channel, LFE included
+    for (int ch = 0; ch < numChannels; ++ch)
+        processTruePeak(bus.channels[ch], bus.truePeak, view[ch] + start, numSamples);
+}
+
+void LoudnessAnalyzer::writeBus(std::ostream& out, const BusLoudness& bus) const {
+    // Empty fields where the run was too short or every block was gated
+    auto write = [&](double value) {
+        out << ",";
+        if (std::isfinite(value))
+            out << value;
+    };
+
+    write(bus.momentary.gatedLoudness(-10.0));
+    write(bus.maxMomentaryPower > 0.0 ? powerToLufs(bus.maxMomentaryPower)
+                                      : std::numeric_limits<double>::quiet_NaN());
+    write(bus.maxShortTermPower > 0.0 ? powerToLufs(bus.maxShortTermPower)
+                                      : std::numeric_limits<double>::quiet_NaN());
+    write(bus.shortTerm.range(-20.0));
+    write(20.0 * std::log10(std::max((double)bus.truePeak, 1e-10)));
+}
+
+void LoudnessAnalyzer::processRun() {
+    if (!csvFile)
+        return;
+
+    auto& out = *csvFile;
+    out << current.runId;
+    writeBus(out, current.inputs);
+    writeBus(out, current.outputs);
+
+    for (const auto& paramName : paramNames) {
+        float value = 0.0f;
+        auto it = current.paramValues.find(paramName);
+        if (it != current.paramValues.end())
+            value = it->second;
+        out << "," << value;
+    }
+    out << "," << current.inputGainDb << "\n";
+}
+
+void LoudnessAnalyzer::beginBlock(const BlockContext& ctx) {
+    // A new run id means the previous run is complete
+    if (ctx.runId == current.runId)
+        return;
+
+    if (current.runId >= 0)
+        processRun();
+
+    current.runId = ctx.runId;
+    current.paramValues = ctx.paramNamedValues;
+    current.inputGainDb = ctx.inputGainDb;
+    current.subBlockLength = std::max(1, (int)std::lround(0.1 * ctx.sampleRate));
+
+    // K-weighting for this run's sample rate: the BS.1770 48 kHz filters re-derived through the bilinear
+    // transform, so every rate gets the same response
+    const double pi = juce::MathConstants<double>::pi;
+    {
+        const double f0 = 1681.974450955533, gainDb = 3.999843853973347, q = 0.7071752369554196;
+        const double k = std::tan(pi * f0 / ctx.sampleRate);
+        const double vh = std::pow(10.0, gainDb / 20.0);
+        const double vb = std::pow(vh, 0.4996667741545416);
+        const double a0 = 1.0 + k / q + k * k;
+        current.shelf = {(vh + vb * k / q + k * k) / a0, 2.0 * (k * k - vh) / a0, (vh - vb * k / q + k * k) / a0,
+                         2.0 * (k * k - 1.0) / a0, (1.0 - k / q + k * k) / a0};
+    }
+    {
+        const double f0 = 38.13547087602444, q = 0.5003270373238773;
+        const double k = std::tan(pi * f0 / ctx.sampleRate);
+        const double a0 = 1.0 + k / q + k * k;
+        current.highPass = {1.0, -2.0, 1.0, 2.0 * (k * k - 1.0) / a0, (1.0 - k / q + k * k) / a0};
+    }
+
+    startBus(current.inputs, ctx.inputs);
+    startBus(current.outputs, ctx.outputs);
+}
+
+void LoudnessAnalyzer::processSamples(const BlockContext& ctx, int start, int numSamples) {
+    accumulate(current.inputs, ctx.inputs, start, numSamples);
+    accumulate(current.outputs, ctx.outputs, start, numSamples);
+}
+
+void LoudnessAnalyzer::processBlock(const BlockContext& ctx) {
+    beginBlock(ctx);
+    processSamples(ctx, 0, ctx.numSamples);
+    endBlock(ctx);
+}
+
+void LoudnessAnalyzer::finish(const juce::File& outDir) {
+    if (current.runId >= 0) {
+        processRun();
+        current.runId = -1;
+    }
+
+    if (csvFile) {
+        csvFile->close();
+        csvFile.reset();
+    }
+}
+
+std::unique_ptr<Analyzer> createLoudnessAnalyzer(const juce::File& outDir, const std::vector<juce::String>& paramNames,
+                                                 const juce::String& signalType) {
+    return std::make_unique<LoudnessAnalyzer>(outDir, paramNames, signalType);
+}
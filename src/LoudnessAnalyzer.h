@@ -0,0 +1,106 @@
+#pragma once
+
+#include "Analyzer.h"
+#include "JuceHeader.h"
+#include <array>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <vector>
+
+// ITU-R BS.1770-4 / EBU R128 loudness of the main input and output buses, one row per run:
+//   - integrated loudness (LUFS) over 400 ms blocks at 75% overlap, gated at -70 LUFS and then 10 LU below the
+//     mean of the blocks that passed,
+//   - momentary (400 ms) and short-term (3 s) loudness maxima,
+//   - loudness range (EBU Tech 3342): the 10th to 95th percentile spread of short-term loudness, gated at
+//     -70 LUFS and then 20 LU below their mean,
+//   - true peak (dBTP) from the BS.1770 Annex 2 4x polyphase interpolator.
+// Channels are K-weighted and summed with the BS.1770 weights: 1.41 for the side surrounds (Ls, Rs, Lss, Rss),
+// LFE left out, 1 for the rest. Gated blocks go into fixed 0.1 LU histograms instead of being kept, so memory
+// does not depend on run length, at the cost of resolving the relative gates and the range percentiles to
+// 0.1 LU. The interpolator works a chunk at a time, tap by tap, so its inner loop vectorises, and skips chunks
+// too quiet to raise the true peak so far.
+// Values a run is too short for (integrated below 400 ms, short-term and range below 3 s) are left empty.
+struct LoudnessAnalyzer : public Analyzer {
+    static constexpr double absoluteGateLufs = -70.0;
+    static constexpr double histogramTopLufs = 10.0; // louder blocks count in the top bin
+    static constexpr double histogramStepLu = 0.1;
+    static constexpr int numHistogramBins = (int)((histogramTopLufs - absoluteGateLufs) / histogramStepLu);
+    static constexpr int truePeakPhases = 4;
+    static constexpr int truePeakTaps = 12;  // per phase
+    static constexpr int truePeakChunk = 64; // samples interpolated at a time
+
+    LoudnessAnalyzer(const juce::File& outDir, const std::vector<juce::String>& paramNames,
+                     const juce::String& signalType);
+    ~LoudnessAnalyzer() override;
+
+    void processBlock(const BlockContext& ctx) override;
+    void finish(const juce::File& outDir) override;
+
+    // AnalyzerPipeline stage interface
+    void beginBlock(const BlockContext& ctx);
+    void processSamples(const BlockContext& ctx, int start, int numSamples);
+    void endBlock(const BlockContext& ctx) {}
+
+private:
+    // Direct form II transposed biquad, normalised so a0 = 1
+    struct Biquad {
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+    };
+
+    struct ChannelState {
+        double weight = 1.0;                // BS.1770 channel weight G
+        double z[4] = {0.0, 0.0, 0.0, 0.0}; // K-weighting filter state, two biquads
+        std::array<float, truePeakTaps - 1 + truePeakChunk> samples{}; // the previous taps - 1, then the chunk
+    };
+
+    // Gated blocks by loudness: count and summed mean-square power per 0.1 LU bin above the absolute gate
+    struct LoudnessHistogram {
+        std::array<int64_t, numHistogramBins> count{};
+        std::array<double, numHistogramBins> power{};
+
+        void clear();
+        void add(double power);
+        double gatedLoudness(double relativeGateLu) const; // power-mean loudness after both gates; NaN if none
+        double range(double relativeGateLu) const;         // 95th minus 10th percentile after both gates
+    };
+
+    struct BusLoudness {
+        std::vector<ChannelState> channels;
+        double subBlockPower = 0.0;         // weighted sum of squares in the 100 ms step in progress
+        int subBlockPos = 0;
+        std::array<double, 30> subBlocks{}; // mean-square power of the last 30 steps (3 s), a ring
+        int64_t numSubBlocks = 0;
+        double maxMomentaryPower = -1.0; // -1 until a full 400 ms block
+        double maxShortTermPower = -1.0; // -1 until a full 3 s block
+        LoudnessHistogram momentary;     // 400 ms gating blocks, for integrated loudness
+        LoudnessHistogram shortTerm;     // 3 s blocks, for loudness range
+        float truePeak = 0.0f;
+    };
+
+    struct RunLoudness {
+        int runId = -1;
+        int subBlockLength = 4800; // samples per 100 ms step
+        Biquad shelf, highPass;
+        BusLoudness inputs, outputs;
+        std::map<juce::String, float> paramValues;
+        float inputGainDb = 0.0f;
+    };
+
+    RunLoudness current;
+    float truePeakGain = 1.0f; // largest sum of |coefficients| over the phases: bounds |output| / max |input|
+    std::vector<juce::String> paramNames;
+    juce::String signalType;
+
+    std::unique_ptr<std::ofstream> csvFile;
+
+    void startBus(BusLoudness& bus, const ChannelView<float>& view);
+    void accumulate(BusLoudness& bus, const ChannelView<float>& view, int start, int numSamples);
+    void processTruePeak(ChannelState& channel, float& truePeak, const float* x, int numSamples) const;
+    void completeSubBlock(BusLoudness& bus);
+    void writeBus(std::ostream& out, const BusLoudness& bus) const;
+    void processRun();
+};
+
+std::unique_ptr<Analyzer> createLoudnessAnalyzer(const juce::File& outDir, const std::vector<juce::String>& paramNames,
+                                                 const juce::String& signalType);
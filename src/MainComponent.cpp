@@ -283,7 +283,8 @@ void MainComponent::loadPlugin() {
     measurementConfig->fillConfig(tempConfig);
 
     juce::String errorMessage;
-    pluginInstance = loadPluginInstance(pluginFile, tempConfig.sampleRate, tempConfig.blockSize, errorMessage);
+    pluginInstance = loadPluginInstance(pluginFile, tempConfig.sampleRate, tempConfig.blockSize, errorMessage,
+                                        getBusLayoutRequest(tempConfig));
 
     if (pluginInstance == nullptr) {
         showError(errorMessage.isEmpty() ? "Failed to load plugin" : errorMessage);
@@ -387,7 +388,8 @@ void MainComponent::runMeasurement() {
             std::cerr << "[Measurement] Creating plugin instance for measurement thread..." << std::endl;
             juce::File pluginFile(config.pluginPath);
             juce::String errorMessage;
-            auto measurementPlugin = loadPluginInstance(pluginFile, config.sampleRate, config.blockSize, errorMessage);
+            auto measurementPlugin = loadPluginInstance(pluginFile, config.sampleRate, config.blockSize, errorMessage,
+                                                        getBusLayoutRequest(config));
 
             if (measurementPlugin == nullptr) {
                 std::cerr << "[Measurement] Failed to create plugin instance: " << errorMessage << std::endl;
@@ -414,7 +416,7 @@ void MainComponent::runMeasurement() {
             std::cerr << "[Measurement] Building run grid..." << std::endl;
             juce::MessageManager::callAsync(
                 [this]() { progressLabel.setText("Building run grid...", juce::dontSendNotification); });
-            auto runs = buildRunGrid(config, paramNames);
+            auto runs = buildRunGrid(config, paramNames, measurementPlugin.get());
             std::cerr << "[Measurement] Generated " << runs.size() << " measurement runs" << std::endl;
 
             // Warn if too many runs and estimate time
@@ -7,6 +7,9 @@ MeasurementConfigComponent::MeasurementConfigComponent() {
     signalTypeCombo.addItem("Sine", 1);
     signalTypeCombo.addItem("Noise", 2);
     signalTypeCombo.addItem("Sweep", 3);
+    signalTypeCombo.addItem("Multi-tone", 4);
+    signalTypeCombo.addItem("MLS", 5);
+    signalTypeCombo.addItem("Level Staircase", 6);
     signalTypeCombo.setSelectedId(1);
     signalTypeCombo.addListener(this);
     addAndMakeVisible(signalTypeCombo);
@@ -29,6 +32,14 @@ MeasurementConfigComponent::MeasurementConfigComponent() {
     sweepEndEditor.addListener(this);
     addAndMakeVisible(sweepEndEditor);
 
+    multiTonePresetLabel.setText("Multi-tone Preset:", juce::dontSendNotification);
+    addAndMakeVisible(multiTonePresetLabel);
+    multiTonePresetCombo.addItem("Log-spaced", 1);
+    multiTonePresetCombo.addItem("SMPTE IMD", 2);
+    multiTonePresetCombo.addItem("CCIF IMD", 3);
+    multiTonePresetCombo.setSelectedId(1);
+    addAndMakeVisible(multiTonePresetCombo);
+
     sampleRateLabel.setText("Sample Rate:", juce::dontSendNotification);
     addAndMakeVisible(sampleRateLabel);
     sampleRateEditor.setText("48000", juce::dontSendNotification);
@@ -76,6 +87,46 @@ MeasurementConfigComponent::MeasurementConfigComponent() {
     thdButton.setToggleState(true, juce::dontSendNotification);
     addAndMakeVisible(thdButton);
 
+    loudnessButton.setButtonText("Loudness");
+    loudnessButton.setToggleState(true, juce::dontSendNotification);
+    addAndMakeVisible(loudnessButton);
+
+    sweepDeconvolutionButton.setButtonText("Sweep Deconvolution");
+    sweepDeconvolutionButton.setToggleState(false, juce::dontSendNotification);
+    addAndMakeVisible(sweepDeconvolutionButton);
+
+    multiToneButton.setButtonText("Multi-tone / IMD");
+    multiToneButton.setToggleState(false, juce::dontSendNotification);
+    addAndMakeVisible(multiToneButton);
+
+    mlsButton.setButtonText("MLS Impulse Response");
+    mlsButton.setToggleState(false, juce::dontSendNotification);
+    addAndMakeVisible(mlsButton);
+
+    levelDistributionButton.setButtonText("Level Distribution");
+    levelDistributionButton.setToggleState(false, juce::dontSendNotification);
+    addAndMakeVisible(levelDistributionButton);
+
+    latencyButton.setButtonText("Latency");
+    latencyButton.setToggleState(false, juce::dontSendNotification);
+    addAndMakeVisible(latencyButton);
+
+    dynamicsButton.setButtonText("Dynamics");
+    dynamicsButton.setToggleState(false, juce::dontSendNotification);
+    addAndMakeVisible(dynamicsButton);
+
+    parameterChangeButton.setButtonText("Parameter Change");
+    parameterChangeButton.setToggleState(false, juce::dontSendNotification);
+    addAndMakeVisible(parameterChangeButton);
+
+    blockCpuButton.setButtonText("Block CPU");
+    blockCpuButton.setToggleState(false, juce::dontSendNotification);
+    addAndMakeVisible(blockCpuButton);
+
+    spectrogramButton.setButtonText("Spectrogram");
+    spectrogramButton.setToggleState(false, juce::dontSendNotification);
+    addAndMakeVisible(spectrogramButton);
+
     updateUI();
 }
 
@@ -109,6 +160,11 @@ void MeasurementConfigComponent::resized() {
     sweepEndEditor.setBounds(sweepRow.removeFromLeft(100));
     bounds.removeFromTop(5);
 
+    auto multiToneRow = bounds.removeFromTop(rowHeight);
+    multiTonePresetLabel.setBounds(multiToneRow.removeFromLeft(150));
+    multiTonePresetCombo.setBounds(multiToneRow.removeFromLeft(150));
+    bounds.removeFromTop(5);
+
     auto audioRow = bounds.removeFromTop(rowHeight);
     sampleRateLabel.setBounds(audioRow.removeFromLeft(120));
     sampleRateEditor.setBounds(audioRow.removeFromLeft(100));
@@ -135,6 +191,28 @@ void MeasurementConfigComponent::resized() {
     linearResponseButton.setBounds(analyzerRow.removeFromLeft(120));
     analyzerRow.removeFromLeft(10);
     thdButton.setBounds(analyzerRow.removeFromLeft(100));
+    analyzerRow.removeFromLeft(10);
+    loudnessButton.setBounds(analyzerRow.removeFromLeft(100));
+
+    auto analyzerRow2 = bounds.removeFromTop(rowHeight);
+    sweepDeconvolutionButton.setBounds(analyzerRow2.removeFromLeft(160));
+    analyzerRow2.removeFromLeft(10);
+    multiToneButton.setBounds(analyzerRow2.removeFromLeft(140));
+    analyzerRow2.removeFromLeft(10);
+    mlsButton.setBounds(analyzerRow2.removeFromLeft(160));
+    analyzerRow2.removeFromLeft(10);
+    blockCpuButton.setBounds(analyzerRow2.removeFromLeft(100));
+
+    auto analyzerRow3 = bounds.removeFromTop(rowHeight);
+    levelDistributionButton.setBounds(analyzerRow3.removeFromLeft(150));
+    analyzerRow3.removeFromLeft(10);
+    latencyButton.setBounds(analyzerRow3.removeFromLeft(100));
+    analyzerRow3.removeFromLeft(10);
+    dynamicsButton.setBounds(analyzerRow3.removeFromLeft(100));
+    analyzerRow3.removeFromLeft(10);
+    parameterChangeButton.setBounds(analyzerRow3.removeFromLeft(150));
+    analyzerRow3.removeFromLeft(10);
+    spectrogramButton.setBounds(analyzerRow3.removeFromLeft(120));
 }
 
 void MeasurementConfigComponent::comboBoxChanged(juce::ComboBox* comboBox) {
@@ -153,8 +231,9 @@ void MeasurementConfigComponent::buttonClicked(juce::Button* button) {
 
 void MeasurementConfigComponent::updateUI() {
     int signalType = signalTypeCombo.getSelectedId();
-    bool showSine = (signalType == 1);
+    bool showSine = (signalType == 1 || signalType == 6);
     bool showSweep = (signalType == 3);
+    bool showMultiTone = (signalType == 4);
 
     sineFreqLabel.setVisible(showSine);
     sineFreqEditor.setVisible(showSine);
@@ -162,6 +241,8 @@ void MeasurementConfigComponent::updateUI() {
     sweepStartEditor.setVisible(showSweep);
     sweepEndLabel.setVisible(showSweep);
     sweepEndEditor.setVisible(showSweep);
+    multiTonePresetLabel.setVisible(showMultiTone);
+    multiTonePresetCombo.setVisible(showMultiTone);
 
     resized();
 }
@@ -174,6 +255,20 @@ void MeasurementConfigComponent::fillConfig(Config& config) {
         config.signalType = "noise";
     else if (signalType == 3)
         config.signalType = "sweep";
+    else if (signalType == 4)
+        config.signalType = "multitone";
+    else if (signalType == 5)
+        config.signalType = "mls";
+    else if (signalType == 6)
+        config.signalType = "staircase";
+
+    int preset = multiTonePresetCombo.getSelectedId();
+    if (preset == 2)
+        config.multiTonePreset = "smpte";
+    else if (preset == 3)
+        config.multiTonePreset = "ccif";
+    else
+        config.multiTonePreset = "log";
 
     config.sineFrequency = sineFreqEditor.getText().getDoubleValue();
     config.sweepStartHz = sweepStartEditor.getText().getDoubleValue();
@@ -204,6 +299,26 @@ void MeasurementConfigComponent::fillConfig(Config& config) {
         config.analyzers.push_back("LinearResponse");
     if (thdButton.getToggleState())
         config.analyzers.push_back("Thd");
+    if (loudnessButton.getToggleState())
+        config.analyzers.push_back("Loudness");
+    if (sweepDeconvolutionButton.getToggleState())
+        config.analyzers.push_back("SweepDeconvolution");
+    if (multiToneButton.getToggleState())
+        config.analyzers.push_back("MultiTone");
+    if (mlsButton.getToggleState())
+        config.analyzers.push_back("Mls");
+    if (levelDistributionButton.getToggleState())
+        config.analyzers.push_back("LevelDistribution");
+    if (latencyButton.getToggleState())
+        config.analyzers.push_back("Latency");
+    if (dynamicsButton.getToggleState())
+        config.analyzers.push_back("Dynamics");
+    if (parameterChangeButton.getToggleState())
+        config.analyzers.push_back("ParameterChange");
+    if (blockCpuButton.getToggleState())
+        config.analyzers.push_back("BlockCpu");
+    if (spectrogramButton.getToggleState())
+        config.analyzers.push_back("Spectrogram");
 }
 
 void MeasurementConfigComponent::loadFromConfig(const Config& config) {
@@ -213,6 +328,19 @@ void MeasurementConfigComponent::loadFromConfig(const Config& config) {
         signalTypeCombo.setSelectedId(2);
     else if (config.signalType == "sweep")
         signalTypeCombo.setSelectedId(3);
+    else if (config.signalType == "multitone")
+        signalTypeCombo.setSelectedId(4);
+    else if (config.signalType == "mls")
+        signalTypeCombo.setSelectedId(5);
+    else if (config.signalType == "staircase")
+        signalTypeCombo.setSelectedId(6);
+
+    if (config.multiTonePreset.equalsIgnoreCase("smpte"))
+        multiTonePresetCombo.setSelectedId(2);
+    else if (config.multiTonePreset.equalsIgnoreCase("ccif"))
+        multiTonePresetCombo.setSelectedId(3);
+    else
+        multiTonePresetCombo.setSelectedId(1);
 
     sineFreqEditor.setText(juce::String(config.sineFrequency), juce::dontSendNotification);
     sweepStartEditor.setText(juce::String(config.sweepStartHz), juce::dontSendNotification);
@@ -239,6 +367,16 @@ void MeasurementConfigComponent::loadFromConfig(const Config& config) {
     transferCurveButton.setToggleState(hasAnalyzer("TransferCurve"), juce::dontSendNotification);
     linearResponseButton.setToggleState(hasAnalyzer("LinearResponse"), juce::dontSendNotification);
     thdButton.setToggleState(hasAnalyzer("Thd"), juce::dontSendNotification);
+    loudnessButton.setToggleState(hasAnalyzer("Loudness"), juce::dontSendNotification);
+    sweepDeconvolutionButton.setToggleState(hasAnalyzer("SweepDeconvolution"), juce::dontSendNotification);
+    multiToneButton.setToggleState(hasAnalyzer("MultiTone"), juce::dontSendNotification);
+    mlsButton.setToggleState(hasAnalyzer("Mls"), juce::dontSendNotification);
+    levelDistributionButton.setToggleState(hasAnalyzer("LevelDistribution"), juce::dontSendNotification);
+    latencyButton.setToggleState(hasAnalyzer("Latency"), juce::dontSendNotification);
+    dynamicsButton.setToggleState(hasAnalyzer("Dynamics"), juce::dontSendNotification);
+    parameterChangeButton.setToggleState(hasAnalyzer("ParameterChange"), juce::dontSendNotification);
+    blockCpuButton.setToggleState(hasAnalyzer("BlockCpu"), juce::dontSendNotification);
+    spectrogramButton.setToggleState(hasAnalyzer("Spectrogram"), juce::dontSendNotification);
 
     updateUI();
 }
@@ -37,6 +37,10 @@ private:
     juce::Label sweepEndLabel;
     juce::TextEditor sweepEndEditor;
 
+    // Multi-tone settings
+    juce::Label multiTonePresetLabel;
+    juce::ComboBox multiTonePresetCombo;
+
     // Audio settings
     juce::Label sampleRateLabel;
     juce::TextEditor sampleRateEditor;
@@ -56,6 +60,16 @@ private:
     juce::ToggleButton transferCurveButton;
     juce::ToggleButton linearResponseButton;
     juce::ToggleButton thdButton;
+    juce::ToggleButton loudnessButton;
+    juce::ToggleButton sweepDeconvolutionButton;
+    juce::ToggleButton multiToneButton;
+    juce::ToggleButton mlsButton;
+    juce::ToggleButton levelDistributionButton;
+    juce::ToggleButton latencyButton;
+    juce::ToggleButton dynamicsButton;
+    juce::ToggleButton parameterChangeButton;
+    juce::ToggleButton blockCpuButton;
+    juce::ToggleButton spectrogramButton;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MeasurementConfigComponent)
 };
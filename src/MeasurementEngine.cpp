@@ -1,23 +1,178 @@
 #include "MeasurementEngine.h"
+#include "AnalyzerPipeline.h"
+#include "AutomationSchedule.h"
+#include "BlockCpuAnalyzer.h"
+#include "BlockSchedule.h"
 #include "BucketSpec.h"
+#include "DynamicsAnalyzer.h"
+#include "GridSampling.h"
+#include "LatencyAnalyzer.h"
+#include "LevelDistributionAnalyzer.h"
+#include "LinearityCheck.h"
 #include "LinearResponseAnalyzer.h"
+#include "LoudnessAnalyzer.h"
+#include "MlsAnalyzer.h"
+#include "MultiToneAnalyzer.h"
+#include "ParameterChangeAnalyzer.h"
 #include "PluginLoader.h"
 #include "RawCsvAnalyzer.h"
 #include "RmsPeakAnalyzer.h"
+#include "SpectrogramAnalyzer.h"
+#include "SweepDeconvolutionAnalyzer.h"
 #include "ThdAnalyzer.h"
 #include "TransferCurveAnalyzer.h"
 #include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <fstream>
 #include <functional>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <type_traits>
 
-std::vector<RunConfig> buildRunGrid(const Config& config, const std::vector<juce::String>& paramNames) {
+// Steps of the level staircase: staircaseLevelsDb, or the input gain buckets when none are given
+static std::vector<float> getStaircaseSteps(const Config& config) {
+    return StaircaseGenerator::buildSteps(config.staircaseLevelsDb.empty() ? config.inputGainBucketsDb
+                                                                           : config.staircaseLevelsDb);
+}
+
+BusLayoutRequest getBusLayoutRequest(const Config& config) {
+    BusLayoutRequest request;
+    request.inputChannels = std::max(0, config.inputChannels);
+    request.outputChannels = std::max(0, config.outputChannels);
+    request.sidechain = !config.sidechain.equalsIgnoreCase("off");
+    return request;
+}
+
+// Runs with the same parameter values under the same host configuration
+static bool sameSetting(const RunConfig& a, const RunConfig& b) {
+    return a.paramValues == b.paramValues && a.sampleRate == b.sampleRate && a.blockSize == b.blockSize &&
+           a.doublePrecision == b.doublePrecision;
+}
+
+// Marks runs whose parameter combination equals an earlier one once discrete parameters are snapped to their
+// steps (and compared by the plugin's text for the step, so choices with the same label match). Each
+// duplicate gets the matching gain run of the first combination as its source and is moved to follow it.
+static void dedupeDiscreteRuns(std::vector<RunConfig>& runs, juce::AudioPluginInstance& plugin) {
+    const ParameterIndex parameterIndex(plugin);
+
+    // Combinations: consecutive runs with the same setting, one per input gain
+    struct Combination {
+        size_t first = 0;
+        size_t count = 0;
+        std::vector<size_t> duplicates;
+    };
+    std::vector<Combination> combinations;
+    std::vector<bool> isDuplicate;
+    std::map<juce::String, size_t> combinationByKey;
+    size_t numDuplicateRuns = 0;
+
+    for (size_t i = 0; i < runs.size();) {
+        size_t end = i + 1;
+        while (end < runs.size() && sameSetting(runs[end], runs[i]))
+            ++end;
+
+        juce::String key = juce::String(runs[i].sampleRate) + "/" + juce::String(runs[i].blockSize) +
+                           (runs[i].doublePrecision ? "/double:" : "/float:");
+        for (const auto& [paramName, value] : runs[i].paramValues) {
+            key += paramName + "=";
+            const auto* param = parameterIndex.find(paramName);
+            if (param != nullptr && param->getNumSteps() < juce::AudioProcessor::getDefaultNumParameterSteps())
+                key += "#" + param->getText(snapToParameterStep(*param, value), 512);
+            else
+                key += juce::String((double)value, 9);
+            key += ";";
+        }
+
+        Combination combination;
+        combination.first = i;
+        combination.count = end - i;
+        auto [existing, inserted] = combinationByKey.insert({key, combinations.size()});
+        const bool duplicate = !inserted && combinations[existing->second].count == combination.count;
+        if (duplicate) {
+            combinations[existing->second].duplicates.push_back(combinations.size());
+            numDuplicateRuns += combination.count;
+        }
+        combinations.push_back(combination);
+        isDuplicate.push_back(duplicate);
+        i = end;
+    }
+
+    if (numDuplicateRuns == 0)
+        return;
+
+    std::vector<RunConfig> ordered;
+    ordered.reserve(runs.size());
+    for (size_t c = 0; c < combinations.size(); ++c) {
+        if (isDuplicate[c])
+            continue;
+
+        const auto& source = combinations[c];
+        for (size_t r = 0; r < source.count; ++r)
+            ordered.push_back(runs[source.first + r]);
+        for (size_t d : source.duplicates) {
+            for (size_t r = 0; r < source.count; ++r) {
+                RunConfig run = runs[combinations[d].first + r];
+                run.sourceRunId = runs[source.first + r].runId;
+                ordered.push_back(run);
+            }
+        }
+    }
+    runs = std::move(ordered);
+
+    std::cerr << "[buildRunGrid] " << numDuplicateRuns << " of " << runs.size()
+              << " runs repeat an equivalent discrete-parameter setting and reuse its measurement" << std::endl;
+}
+
+// Repeats the parameter grid once per host configuration (outermost, so each configuration is prepared once),
+// then removes discrete-parameter duplicates unless automation is set (automated runs are always measured, so
+// there is nothing to reuse). Processing precision is part of the host configuration: the plugin has to be
+// re-prepared to switch it.
+static void finishRunGrid(std::vector<RunConfig>& runs, const Config& config, juce::AudioPluginInstance* plugin) {
+    const std::vector<double> sampleRates =
+        config.sampleRateBuckets.empty() ? std::vector<double>{config.sampleRate} : config.sampleRateBuckets;
+    const std::vector<int> blockSizes =
+        config.blockSizeBuckets.empty() ? std::vector<int>{config.blockSize} : config.blockSizeBuckets;
+    std::vector<bool> precisions{config.precision.equalsIgnoreCase("double")};
+    if (config.precision.equalsIgnoreCase("both"))
+        precisions = {false, true};
+
+    const size_t numHostConfigs = sampleRates.size() * blockSizes.size() * precisions.size();
+    std::vector<RunConfig> expanded;
+    expanded.reserve(runs.size() * numHostConfigs);
+    for (double sampleRate : sampleRates) {
+        for (int blockSize : blockSizes) {
+            for (bool doublePrecision : precisions) {
+                for (const auto& run : runs) {
+                    RunConfig hostRun = run;
+                    hostRun.runId = (int)expanded.size();
+                    hostRun.sampleRate = sampleRate;
+                    hostRun.blockSize = blockSize;
+                    hostRun.doublePrecision = doublePrecision;
+                    expanded.push_back(hostRun);
+                }
+            }
+        }
+    }
+    if (numHostConfigs > 1)
+        std::cerr << "[buildRunGrid] " << numHostConfigs << " host configurations, " << expanded.size()
+                  << " total runs" << std::endl;
+    runs = std::move(expanded);
+
+    if (plugin != nullptr && config.dedupeDiscrete && config.automation.empty())
+        dedupeDiscreteRuns(runs, *plugin);
+}
+
+std::vector<RunConfig> buildRunGrid(const Config& config, const std::vector<juce::String>& paramNames,
+                                    juce::AudioPluginInstance* plugin) {
     std::cerr << "[buildRunGrid] Starting with " << paramNames.size() << " parameters, "
               << config.parameterBuckets.size() << " bucket configs" << std::endl;
     std::vector<RunConfig> runs;
 
     // Convert ParameterBucketConfig to BucketSpec and generate values
     std::vector<std::pair<juce::String, std::vector<float>>> paramValueLists;
+    std::vector<BucketSpec> specs;
 
     for (const auto& bucketConfig : config.parameterBuckets) {
         std::cerr << "[buildRunGrid] Processing bucket for parameter: " << bucketConfig.paramName << std::endl;
@@ -33,19 +188,47 @@ std::vector<RunConfig> buildRunGrid(const Config& config, const std::vector<juce
         std::cerr << "[buildRunGrid] Generated " << values.size() << " values for " << bucketConfig.paramName
                   << std::endl;
         paramValueLists.push_back({bucketConfig.paramName, values});
+        specs.push_back(spec);
     }
 
-    // Build Cartesian product of parameter values and input gain buckets
+    // Build Cartesian product of parameter values and input gain buckets. The staircase steps through the
+    // levels within each run, so it needs one run per parameter combination.
+    const std::vector<float> inputGainsDb =
+        config.signalType.equalsIgnoreCase("staircase") ? std::vector<float>{0.0f} : config.inputGainBucketsDb;
     int runId = 0;
-    std::cerr << "[buildRunGrid] Building Cartesian product with " << config.inputGainBucketsDb.size()
-              << " input gain buckets..." << std::endl;
+
+    // Space-filling sampling: gridSamples joint draws over the parameter ranges instead of the full product,
+    // each still measured at every input gain bucket
+    if (!config.gridSampling.isEmpty() && !config.gridSampling.equalsIgnoreCase("cartesian")) {
+        const auto points = generateSamplePoints(config.gridSampling, std::max(1, config.gridSamples),
+                                                 (int)specs.size(), (uint64_t)(uint32_t)config.seed);
+        for (const auto& point : points) {
+            std::map<juce::String, float> params;
+            for (size_t d = 0; d < specs.size(); ++d)
+                params[specs[d].paramName] = specs[d].valueAt(point[d]);
+            for (float inputGainDb : inputGainsDb) {
+                RunConfig run;
+                run.runId = runId++;
+                run.paramValues = params;
+                run.inputGainDb = inputGainDb;
+                runs.push_back(run);
+            }
+        }
+        std::cerr << "[buildRunGrid] Complete: " << points.size() << " " << config.gridSampling
+                  << " samples, generated " << runs.size() << " total runs" << std::endl;
+        finishRunGrid(runs, config, plugin);
+        return runs;
+    }
+
+    std::cerr << "[buildRunGrid] Building Cartesian product with " << inputGainsDb.size() << " input gain buckets..."
+              << std::endl;
 
     // Helper function to generate combinations recursively
     std::function<void(int, std::map<juce::String, float>)> generateCombinations;
     generateCombinations = [&](int paramIndex, std::map<juce::String, float> currentParams) {
         if (paramIndex >= (int)paramValueLists.size()) {
             // All parameters set, now combine with input gain buckets
-            for (float inputGainDb : config.inputGainBucketsDb) {
+            for (float inputGainDb : inputGainsDb) {
                 RunConfig run;
                 run.runId = runId++;
                 run.paramValues = currentParams;
@@ -69,6 +252,7 @@ std::vector<RunConfig> buildRunGrid(const Config& config, const std::vector<juce
 
     generateCombinations(0, {});
     std::cerr << "[buildRunGrid] Complete: generated " << runs.size() << " total runs" << std::endl;
+    finishRunGrid(runs, config, plugin);
     return runs;
 }
 
@@ -76,16 +260,52 @@ std::vector<std::unique_ptr<Analyzer>> createAnalyzers(const Config& config, con
                                                        const std::vector<juce::String>& paramNames) {
     std::vector<std::unique_ptr<Analyzer>> analyzers;
 
+    // Sample-streaming analyzers are collected separately so they can share one pass over each block
+    std::unique_ptr<RmsPeakAnalyzer> rmsPeak;
+    std::unique_ptr<TransferCurveAnalyzer> transferCurve;
+    std::unique_ptr<LoudnessAnalyzer> loudness;
+
     for (const auto& analyzerName : config.analyzers) {
         if (analyzerName.equalsIgnoreCase("RawCsv")) {
             analyzers.push_back(createRawCsvAnalyzer(outDir, config.signalType));
         } else if (analyzerName.equalsIgnoreCase("RmsPeak")) {
-            analyzers.push_back(createRmsPeakAnalyzer(outDir, paramNames, config.signalType));
+            rmsPeak = std::make_unique<RmsPeakAnalyzer>(outDir, paramNames, config.signalType);
         } else if (analyzerName.equalsIgnoreCase("TransferCurve")) {
-            analyzers.push_back(createTransferCurveAnalyzer(outDir, 512, paramNames, config.signalType));
+            transferCurve = std::make_unique<TransferCurveAnalyzer>(outDir, config.transferCurveBins,
+                                                                    config.transferCurveStereo, paramNames,
+                                                                    config.signalType);
+        } else if (analyzerName.equalsIgnoreCase("Loudness")) {
+            loudness = std::make_unique<LoudnessAnalyzer>(outDir, paramNames, config.signalType);
+        } else if (analyzerName.equalsIgnoreCase("Dynamics")) {
+            if (config.signalType.equalsIgnoreCase("staircase")) {
+                analyzers.push_back(createDynamicsAnalyzer(outDir, config.sineFrequency, config.seconds,
+                                                           getStaircaseSteps(config), paramNames, config.signalType));
+            } else {
+                std::cerr << "Warning: Dynamics analyzer requires staircase signal type" << std::endl;
+            }
+        } else if (analyzerName.equalsIgnoreCase("ParameterChange")) {
+            if (!config.automation.empty()) {
+                analyzers.push_back(createParameterChangeAnalyzer(outDir, config.automation,
+                                                                  config.automationRampStepSamples, paramNames,
+                                                                  config.signalType));
+            } else {
+                std::cerr << "Warning: ParameterChange analyzer requires automation events" << std::endl;
+            }
+        } else if (analyzerName.equalsIgnoreCase("BlockCpu")) {
+            analyzers.push_back(createBlockCpuAnalyzer(outDir, paramNames, config.signalType));
+        } else if (analyzerName.equalsIgnoreCase("Latency")) {
+            analyzers.push_back(createLatencyAnalyzer(outDir, paramNames, config.signalType));
+        } else if (analyzerName.equalsIgnoreCase("Spectrogram")) {
+            analyzers.push_back(createSpectrogramAnalyzer(outDir, config.spectrogramFftSize, config.spectrogramHop,
+                                                          config.spectrogramWindow, config.spectrogramFloorDb,
+                                                          paramNames, config.signalType));
+        } else if (analyzerName.equalsIgnoreCase("LevelDistribution")) {
+            analyzers.push_back(createLevelDistributionAnalyzer(outDir, paramNames, config.signalType));
         } else if (analyzerName.equalsIgnoreCase("LinearResponse")) {
             if (config.signalType.equalsIgnoreCase("noise") || config.signalType.equalsIgnoreCase("sweep")) {
-                analyzers.push_back(createLinearResponseAnalyzer(outDir, 4096, paramNames, config.signalType));
+                analyzers.push_back(createLinearResponseAnalyzer(
+                    outDir, 4096, config.linearResponseOverlap, config.linearResponseSmoothing,
+                    config.linearResponsePoints, config.linearResponseEnvelope, paramNames, config.signalType));
             } else {
                 std::cerr << "Warning: LinearResponse analyzer requires noise or sweep signal type" << std::endl;
             }
@@ -96,34 +316,492 @@ std::vector<std::unique_ptr<Analyzer>> createAnalyzers(const Config& config, con
             } else {
                 std::cerr << "Warning: Thd analyzer requires sine signal type" << std::endl;
             }
+        } else if (analyzerName.equalsIgnoreCase("SweepDeconvolution")) {
+            if (config.signalType.equalsIgnoreCase("sweep")) {
+                analyzers.push_back(createSweepDeconvolutionAnalyzer(outDir, config.sweepStartHz, config.sweepEndHz,
+                                                                     config.seconds, paramNames, config.signalType));
+            } else {
+                std::cerr << "Warning: SweepDeconvolution analyzer requires sweep signal type" << std::endl;
+            }
+        } else if (analyzerName.equalsIgnoreCase("MultiTone")) {
+            if (config.signalType.equalsIgnoreCase("multitone")) {
+                analyzers.push_back(createMultiToneAnalyzer(
+                    outDir, config.multiTonePreset, config.multiToneStartHz, config.multiToneEndHz,
+                    config.multiToneCount, MultiToneGenerator::defaultPeriodLength, paramNames, config.signalType));
+            } else {
+                std::cerr << "Warning: MultiTone analyzer requires multitone signal type" << std::endl;
+            }
+        } else if (analyzerName.equalsIgnoreCase("Mls")) {
+            if (config.signalType.equalsIgnoreCase("mls")) {
+                analyzers.push_back(createMlsAnalyzer(outDir, config.mlsOrder, paramNames, config.signalType));
+            } else {
+                std::cerr << "Warning: Mls analyzer requires mls signal type" << std::endl;
+            }
         } else {
             std::cerr << "Warning: Unknown analyzer: " << analyzerName << std::endl;
         }
     }
 
+    // Stages that were not configured stay null and are skipped
+    if (rmsPeak || transferCurve || loudness)
+        analyzers.push_back(createAnalyzerPipeline(std::move(rmsPeak), std::move(transferCurve), std::move(loudness)));
+
     return analyzers;
 }
 
+// Fixed delay applied in place to every channel of a float or double buffer; a delay of 0 is a no-op
+struct AlignmentDelay {
+    std::vector<std::vector<double>> lines;
+    int position = 0;
+
+    AlignmentDelay(int numChannels, int delaySamples) {
+        if (delaySamples > 0)
+            lines.assign(numChannels, std::vector<double>(delaySamples, 0.0));
+    }
+
+    template <typename SampleType>
+    void process(juce::AudioBuffer<SampleType>& buffer, int numSamples) {
+        if (lines.empty())
+            return;
+
+        const int length = (int)lines[0].size();
+        const int channels = std::min(buffer.getNumChannels(), (int)lines.size());
+        for (int ch = 0; ch < channels; ++ch) {
+            auto* data = buffer.getWritePointer(ch);
+            auto& line = lines[ch];
+            int pos = position;
+            for (int i = 0; i < numSamples; ++i) {
+                const auto delayed = (SampleType)line[pos];
+                line[pos] = (double)data[i];
+                data[i] = delayed;
+                if (++pos >= length)
+                    pos = 0;
+            }
+        }
+        position = (position + numSamples) % length;
+    }
+};
+
+// Rounds the first numSamples of the first numChannels channels of a double-precision block into a float buffer
+static void convertBlock(const juce::AudioBuffer<double>& source, juce::AudioBuffer<float>& dest, int numChannels,
+                         int numSamples) {
+    for (int ch = 0; ch < numChannels; ++ch) {
+        const double* in = source.getReadPointer(ch);
+        float* out = dest.getWritePointer(ch);
+        for (int i = 0; i < numSamples; ++i)
+            out[i] = (float)in[i];
+    }
+}
+
+// One run's analyzer input (after alignment, sidechain channels included) and main output, for replaying at
+// another input gain. Samples are kept at double precision, so a double-precision run replays without rounding.
+struct RunRecording {
+    std::vector<std::vector<double>> inputs;
+    std::vector<std::vector<double>> outputs;
+    std::vector<int> blockSizes;
+    int reportedLatency = 0;
+    int alignment = 0;
+
+    void clear() {
+        inputs.clear();
+        outputs.clear();
+        blockSizes.clear();
+    }
+
+    template <typename SampleType>
+    void append(const juce::AudioBuffer<SampleType>& in, const juce::AudioBuffer<SampleType>& out, int numOutputs,
+                int numSamples) {
+        inputs.resize(in.getNumChannels());
+        outputs.resize(numOutputs);
+        for (int ch = 0; ch < in.getNumChannels(); ++ch)
+            inputs[ch].insert(inputs[ch].end(), in.getReadPointer(ch), in.getReadPointer(ch) + numSamples);
+        for (int ch = 0; ch < numOutputs; ++ch)
+            outputs[ch].insert(outputs[ch].end(), out.getReadPointer(ch), out.getReadPointer(ch) + numSamples);
+        blockSizes.push_back(numSamples);
+    }
+
+    RunRecording scaledBy(float scale) const {
+        RunRecording result = *this;
+        for (auto* bus : {&result.inputs, &result.outputs}) {
+            for (auto& channel : *bus) {
+                for (auto& sample : channel)
+                    sample *= (double)scale;
+            }
+        }
+        return result;
+    }
+
+    template <typename SampleType>
+    void read(juce::AudioBuffer<SampleType>& in, juce::AudioBuffer<SampleType>& out, int64_t firstSample,
+              int numSamples, float scale) const {
+        auto readChannels = [&](const std::vector<std::vector<double>>& source, juce::AudioBuffer<SampleType>& dest) {
+            for (int ch = 0; ch < std::min((int)source.size(), dest.getNumChannels()); ++ch) {
+                auto* data = dest.getWritePointer(ch);
+                for (int i = 0; i < numSamples; ++i)
+                    data[i] = (SampleType)((double)scale * source[ch][firstSample + i]);
+            }
+        };
+        readChannels(inputs, in);
+        readChannels(outputs, out);
+    }
+};
+
+// How the engine lays out the plugin's buses. inputBuffer holds the main input channels the analyzers see, then
+// the sidechain channels. The buffer handed to processBlock (outputBuffer) follows the plugin's own layout: main
+// input, then sidechain channels, with the main output in its first channels.
+struct BusChannels {
+    int mainInputs = 0;      // main input channels of the plugin
+    int inputs = 1;          // main input channels the analyzers see; at least one, as the stimulus reference
+    int sidechain = 0;       // channels of the plugin's other enabled input buses
+    int outputs = 1;         // main output channels
+    int processChannels = 1; // channels of the buffer handed to processBlock
+    std::vector<juce::String> inputNames, sidechainNames, outputNames;
+
+    explicit BusChannels(const juce::AudioPluginInstance& plugin) {
+        mainInputs = plugin.getMainBusNumInputChannels();
+        inputs = std::max(1, mainInputs);
+        sidechain = std::max(0, plugin.getTotalNumInputChannels() - mainInputs);
+        outputs = std::max(1, plugin.getMainBusNumOutputChannels());
+        processChannels = std::max({inputs, mainInputs + sidechain, plugin.getTotalNumOutputChannels(), outputs});
+
+        inputNames = getChannelNames(plugin.getChannelLayoutOfBus(true, 0), inputs);
+        sidechainNames = getChannelNames(plugin.getBusCount(true) > 1 ? plugin.getChannelLayoutOfBus(true, 1)
+                                                                      : juce::AudioChannelSet(),
+                                         sidechain);
+        outputNames = getChannelNames(plugin.getChannelLayoutOfBus(false, 0), outputs);
+    }
+};
+
+template <typename SampleType>
+static ChannelView<SampleType> channelView(const juce::AudioBuffer<SampleType>& buffer, int firstChannel,
+                                           int numChannels, const std::vector<juce::String>& names) {
+    ChannelView<SampleType> view;
+    view.channels = buffer.getArrayOfReadPointers() + firstChannel;
+    view.numChannels = numChannels;
+    view.names = names.data();
+    return view;
+}
+
+// Re-prepares a plugin for a host configuration; the processing precision can only change while it is released
+static void preparePlugin(juce::AudioPluginInstance& plugin, double sampleRate, int blockSize, bool doublePrecision) {
+    plugin.releaseResources();
+    plugin.setProcessingPrecision(doublePrecision ? juce::AudioProcessor::doublePrecision
+                                                  : juce::AudioProcessor::singlePrecision);
+    plugin.prepareToPlay(sampleRate, blockSize);
+}
+
+// A plugin instance prepared for one host configuration, with the grid's parameters resolved on it
+struct PreparedInstance {
+    juce::AudioPluginInstance* plugin = nullptr;
+    std::unique_ptr<juce::AudioPluginInstance> owned; // null for the caller's instance
+    double sampleRate = 0.0;
+    int blockSize = 0;
+    bool doublePrecision = false;
+    std::unique_ptr<ParameterIndex> parameterIndex;
+    std::unique_ptr<ParameterSetter> parameterSetter;
+    std::vector<juce::AudioProcessorParameter*> automatedParams;
+    std::vector<float> automatedDefaults; // automated parameter values before the first run
+    uint64_t lastUse = 0;
+
+    PreparedInstance(juce::AudioPluginInstance& instance, double newSampleRate, int newBlockSize,
+                     const std::vector<juce::String>& paramNames, const std::vector<juce::String>& automatedNames)
+        : plugin(&instance), sampleRate(newSampleRate), blockSize(newBlockSize),
+          doublePrecision(instance.isUsingDoublePrecision()) {
+        parameterIndex = std::make_unique<ParameterIndex>(instance);
+        parameterSetter = std::make_unique<ParameterSetter>(*parameterIndex, paramNames);
+        for (const auto& name : automatedNames) {
+            auto* param = parameterIndex->find(name);
+            if (param == nullptr)
+                std::cerr << "Warning: Automated parameter not found: " << name << std::endl;
+            automatedParams.push_back(param);
+            automatedDefaults.push_back(param != nullptr ? param->getValue() : 0.0f);
+        }
+    }
+};
+
+// Instances for the host configurations (sample rate, block size, precision) of a grid. The caller's instance
+// serves the configuration it was prepared for. Each other configuration gets an instance of its own, loaded from
+// pluginPath and prepared once; beyond maxInstances the least recently used one is released. If pluginPath
+// does not load (or maxInstances is 0), the caller's instance is re-prepared for each configuration instead,
+// and restored to its own configuration at the end.
+class PreparedInstanceCache {
+public:
+    PreparedInstanceCache(juce::AudioPluginInstance& plugin, double sampleRate, int blockSize, const Config& config,
+                          const std::vector<juce::String>& paramNames,
+                          const std::vector<juce::String>& automatedNames)
+        : pluginPath(config.pluginPath), busLayout(getBusLayoutRequest(config)),
+          maxInstances(std::max(0, config.maxPreparedInstances)), paramNames(paramNames),
+          automatedNames(automatedNames), callerSampleRate(sampleRate), callerBlockSize(blockSize),
+          callerDoublePrecision(plugin.isUsingDoublePrecision()) {
+        instances.push_back(
+            std::make_unique<PreparedInstance>(plugin, sampleRate, blockSize, paramNames, automatedNames));
+        canLoad = maxInstances > 0 && pluginPath.isNotEmpty();
+    }
+
+    ~PreparedInstanceCache() {
+        auto& caller = *instances.front();
+        if (caller.sampleRate != callerSampleRate || caller.blockSize != callerBlockSize ||
+            caller.doublePrecision != callerDoublePrecision)
+            preparePlugin(*caller.plugin, callerSampleRate, callerBlockSize, callerDoublePrecision);
+    }
+
+    PreparedInstance& get(double sampleRate, int blockSize, bool doublePrecision) {
+        ++useCount;
+        for (auto& instance : instances) {
+            if (instance->sampleRate == sampleRate && instance->blockSize == blockSize &&
+                instance->doublePrecision == doublePrecision) {
+                instance->lastUse = useCount;
+                return *instance;
+            }
+        }
+
+        if (canLoad) {
+            juce::String errorMessage;
+            auto loaded = loadPluginInstance(juce::File(pluginPath), sampleRate, blockSize, errorMessage, busLayout);
+            const auto& callerPlugin = *instances.front()->plugin;
+            if (loaded != nullptr &&
+                (loaded->getTotalNumInputChannels() != callerPlugin.getTotalNumInputChannels() ||
+                 loaded->getTotalNumOutputChannels() != callerPlugin.getTotalNumOutputChannels() ||
+                 loaded->getMainBusNumInputChannels() != callerPlugin.getMainBusNumInputChannels())) {
+                errorMessage = "its bus layout differs from the loaded instance's";
+                loaded.reset();
+            }
+            if (loaded != nullptr) {
+                if ((int)instances.size() > maxInstances) {
+                    auto leastRecent = std::min_element(instances.begin() + 1, instances.end(),
+                                                        [](const auto& a, const auto& b) {
+                                                            return a->lastUse < b->lastUse;
+                                                        });
+                    (*leastRecent)->plugin->releaseResources();
+                    instances.erase(leastRecent);
+                }
+
+                if (doublePrecision)
+                    preparePlugin(*loaded, sampleRate, blockSize, true);
+                std::cerr << "[runMeasurementGrid] Prepared an instance for " << sampleRate << " Hz, " << blockSize
+                          << " samples" << (doublePrecision ? ", double precision" : "") << std::endl;
+                auto instance = std::make_unique<PreparedInstance>(*loaded, sampleRate, blockSize, paramNames,
+                                                                   automatedNames);
+                instance->owned = std::move(loaded);
+                instance->lastUse = useCount;
+                instances.push_back(std::move(instance));
+                return *instances.back();
+            }
+
+            std::cerr << "Warning: Could not load another plugin instance (" << errorMessage
+                      << "); re-preparing the loaded instance for each host configuration" << std::endl;
+            canLoad = false;
+        }
+
+        auto& caller = *instances.front();
+        preparePlugin(*caller.plugin, sampleRate, blockSize, doublePrecision);
+        caller.sampleRate = sampleRate;
+        caller.blockSize = blockSize;
+        caller.doublePrecision = doublePrecision;
+        caller.lastUse = useCount;
+        return caller;
+    }
+
+private:
+    juce::String pluginPath;
+    BusLayoutRequest busLayout;
+    int maxInstances;
+    std::vector<juce::String> paramNames;
+    std::vector<juce::String> automatedNames;
+    double callerSampleRate;
+    int callerBlockSize;
+    bool callerDoublePrecision;
+    bool canLoad = false;
+    uint64_t useCount = 0;
+    std::vector<std::unique_ptr<PreparedInstance>> instances; // [0] is the caller's
+};
+
 void runMeasurementGrid(juce::AudioPluginInstance& plugin, double sampleRate, int blockSize, int64_t totalSamples,
                         const std::vector<RunConfig>& runs, const std::vector<std::unique_ptr<Analyzer>>& analyzers,
                         const Config& config, const juce::File& outDir, std::function<void(int)> progressCallback) {
     std::cerr << "[runMeasurementGrid] Starting with " << runs.size() << " runs, " << totalSamples << " samples per run"
               << std::endl;
-    auto paramMap = buildParameterMap(plugin, false); // Use all parameters for measurement
-    std::cerr << "[runMeasurementGrid] Built parameter map with " << paramMap.size() << " parameters" << std::endl;
-
     // Build parameter name list in order
     std::vector<juce::String> paramNames;
     for (const auto& bucket : config.parameterBuckets) {
         paramNames.push_back(bucket.paramName);
     }
 
-    juce::AudioBuffer<float> inputBuffer(2, blockSize);
-    juce::AudioBuffer<float> outputBuffer(2, blockSize);
+    // In-run automation: restored to the parameters' pre-measurement value (or the run's bucket value) at the
+    // start of every run. Event positions depend on the sample rate, so the schedule follows the run's.
+    double automationSampleRate = sampleRate;
+    AutomationSchedule automation(config.automation, automationSampleRate, config.automationRampStepSamples);
+    std::vector<float> automationStart;
+    std::vector<int> changedParams;
+
+    // Plugin instances per host configuration, each with the bucketed (and automated) parameters resolved once
+    PreparedInstanceCache instances(plugin, sampleRate, blockSize, config, paramNames,
+                                    automation.getParameterNames());
+    std::vector<float> runParamValues(paramNames.size());
+
+    int maxBlockSize = blockSize;
+    for (const auto& run : runs)
+        maxBlockSize = std::max(maxBlockSize, run.blockSize);
+    double runSampleRate = sampleRate;
+
+    // Double-precision runs process in float when the plugin only supports float
+    const bool supportsDouble = plugin.supportsDoublePrecisionProcessing();
+    if (!supportsDouble && std::any_of(runs.begin(), runs.end(), [](const auto& run) { return run.doublePrecision; }))
+        std::cerr << "Warning: Plugin does not support double-precision processing; processing in float" << std::endl;
+    auto usesDouble = [&](const RunConfig& run) { return run.doublePrecision && supportsDouble; };
+
+    // Host configuration table: one row per run with its processing time, when the grid has host dimensions
+    std::unique_ptr<std::ofstream> hostFile;
+    if (!config.sampleRateBuckets.empty() || !config.blockSizeBuckets.empty() ||
+        !config.precision.equalsIgnoreCase("float")) {
+        juce::String filename = "grid_host_" + config.signalType.toLowerCase() + ".csv";
+        hostFile = std::make_unique<std::ofstream>(outDir.getChildFile(filename).getFullPathName().toStdString());
+        if (!hostFile->is_open()) {
+            std::cerr << "Failed to open " << filename.toStdString() << " for writing" << std::endl;
+            hostFile.reset();
+        } else {
+            *hostFile << "runId,sampleRate,blockSize,precision,latencySamples,measured,processMs,cpuLoad";
+            for (const auto& paramName : paramNames)
+                *hostFile << "," << paramName.toStdString();
+            *hostFile << ",inputGainDb\n";
+        }
+    }
+    auto writeHostRow = [&](const RunConfig& run, int blockSizeUsed, int latencySamples, bool measured,
+                            double processSeconds, int64_t numSamples) {
+        if (!hostFile)
+            return;
+
+        auto& out = *hostFile;
+        out << run.runId << "," << runSampleRate << "," << blockSizeUsed << ","
+            << (usesDouble(run) ? "double" : "float") << "," << latencySamples << "," << (measured ? 1 : 0) << ",";
+        if (measured && numSamples > 0)
+            out << 1000.0 * processSeconds << "," << processSeconds * runSampleRate / (double)numSamples;
+        else
+            out << ",";
+        for (const auto& paramName : paramNames) {
+            float value = 0.0f;
+            auto it = run.paramValues.find(paramName);
+            if (it != run.paramValues.end())
+                value = it->second;
+            out << "," << value;
+        }
+        out << "," << run.inputGainDb << "\n";
+    };
+
+    // Block sizes within each run; never above the size the run's instance was prepared for
+    BlockSchedule blockSchedule(config.blockSchedule, config.minBlockSize, juce::File(config.blockTraceFile),
+                                deriveRunSeed((uint64_t)(uint32_t)config.seed, -2));
+
+    // Buffers follow the plugin's negotiated bus layout, so no work goes to channels it does not have. The
+    // sidechain carries the stimulus at sidechainGainDb relative to the main input, or silence.
+    const BusChannels bus(plugin);
+    const float sidechainGain =
+        config.sidechain.equalsIgnoreCase("stimulus") ? std::pow(10.0f, config.sidechainGainDb / 20.0f) : 0.0f;
+
+    // Double-precision runs render and process in the double buffers; the float buffers then get a rounded copy,
+    // so analyzers that only read float keep working
+    juce::AudioBuffer<float> inputBuffer(bus.inputs + bus.sidechain, maxBlockSize);
+    juce::AudioBuffer<float> outputBuffer(bus.processChannels, maxBlockSize);
+    juce::AudioBuffer<double> inputBufferDouble(bus.inputs + bus.sidechain, maxBlockSize);
+    juce::AudioBuffer<double> outputBufferDouble(bus.processChannels, maxBlockSize);
     juce::MidiBuffer midiBuffer;
 
+    // Hands the block in inputBuffer / outputBuffer (and the double buffers) to every analyzer
+    auto analyzeBlock = [&](const RunConfig& run, int64_t firstSample, int numSamples, int reportedLatency,
+                            int alignment, int parameterChanges, double processSeconds, bool measured) {
+        BlockContext ctx;
+        ctx.firstSample = firstSample;
+        ctx.sampleRate = runSampleRate;
+        ctx.numSamples = numSamples;
+        ctx.inputs = channelView(inputBuffer, 0, bus.inputs, bus.inputNames);
+        ctx.outputs = channelView(outputBuffer, 0, bus.outputs, bus.outputNames);
+        ctx.sidechain = channelView(inputBuffer, bus.inputs, bus.sidechain, bus.sidechainNames);
+        ctx.inL = ctx.inputs[0];
+        ctx.inR = bus.inputs > 1 ? ctx.inputs[1] : nullptr;
+        ctx.outL = ctx.outputs[0];
+        ctx.outR = bus.outputs > 1 ? ctx.outputs[1] : nullptr;
+        if (usesDouble(run)) {
+            ctx.inputsDouble = channelView(inputBufferDouble, 0, bus.inputs, bus.inputNames);
+            ctx.outputsDouble = channelView(outputBufferDouble, 0, bus.outputs, bus.outputNames);
+        }
+        ctx.runId = run.runId;
+        ctx.paramNamedValues = run.paramValues;
+        ctx.inputGainDb = run.inputGainDb;
+        ctx.reportedLatencySamples = reportedLatency;
+        ctx.alignmentSamples = alignment;
+        ctx.automationValues = automation.getValues();
+        ctx.parameterChanges = parameterChanges;
+        ctx.processSeconds = processSeconds;
+        ctx.measured = measured;
+
+        // Build params vector in fixed order
+        for (const auto& paramName : paramNames) {
+            float value = 0.0f;
+            auto it = run.paramValues.find(paramName);
+            if (it != run.paramValues.end())
+                value = it->second;
+            ctx.params.push_back(value);
+        }
+
+        // Process through analyzers
+        for (auto& analyzer : analyzers) {
+            analyzer->processBlock(ctx);
+        }
+    };
+
+    // Feeds a recording to the analyzers as `run`, scaled to its input gain
+    auto replayRecording = [&](const RunRecording& source, const RunConfig& run, float scale) {
+        int64_t firstSample = 0;
+        for (int numSamples : source.blockSizes) {
+            source.read(inputBuffer, outputBuffer, firstSample, numSamples, scale);
+            if (usesDouble(run))
+                source.read(inputBufferDouble, outputBufferDouble, firstSample, numSamples, scale);
+            analyzeBlock(run, firstSample, numSamples, source.reportedLatency, source.alignment, 0, 0.0, false);
+            firstSample += numSamples;
+        }
+        writeHostRow(run, run.blockSize > 0 ? run.blockSize : blockSize, source.reportedLatency, false, 0.0,
+                     firstSample);
+    };
+
+    // Discrete-parameter duplicates (see buildRunGrid) follow their source run, whose recording is kept until
+    // its last duplicate has been replayed. Automated runs are always measured, for their timing.
+    std::map<int, size_t> lastDuplicate; // source run id -> index of its last duplicate
+    if (automation.isEmpty()) {
+        for (size_t runIndex = 0; runIndex < runs.size(); ++runIndex) {
+            if (runs[runIndex].sourceRunId >= 0)
+                lastDuplicate[runs[runIndex].sourceRunId] = runIndex;
+        }
+    }
+    std::map<int, RunRecording> sourceRecordings;
+
+    // Linearity check: each parameter combination's gain buckets are consecutive runs. A combination that
+    // passes is measured at its first gain and the recording is scaled to the others. Automation makes a
+    // run time-variant, so it disables the check, and so does a sidechain stimulus (the probe drives only the
+    // main input).
+    const bool checkLinear = config.linearityCheck && automation.isEmpty() && sidechainGain == 0.0f;
+    std::unique_ptr<std::ofstream> linearityFile;
+    if (checkLinear) {
+        juce::String filename = "grid_linearity_" + config.signalType.toLowerCase() + ".csv";
+        linearityFile =
+            std::make_unique<std::ofstream>(outDir.getChildFile(filename).getFullPathName().toStdString());
+        if (!linearityFile->is_open()) {
+            std::cerr << "Failed to open " << filename.toStdString() << " for writing" << std::endl;
+            linearityFile.reset();
+        }
+    }
+    if (linearityFile) {
+        *linearityFile << "runId,homogeneityErrorDb,superpositionErrorDb,linear,synthesisedRuns";
+        for (const auto& paramName : paramNames)
+            *linearityFile << "," << paramName.toStdString();
+        *linearityFile << "\n";
+    }
+    RunRecording recording;
+    bool replayGroup = false;
+    float recordingGainDb = 0.0f;
+
     int runCount = 0;
-    for (const auto& run : runs) {
+    for (size_t runIndex = 0; runIndex < runs.size(); ++runIndex) {
+        const auto& run = runs[runIndex];
         runCount++;
         if (progressCallback) {
             progressCallback(run.runId);
@@ -132,9 +810,99 @@ void runMeasurementGrid(juce::AudioPluginInstance& plugin, double sampleRate, in
             std::cerr << "[runMeasurementGrid] Running measurement " << run.runId << " / " << runs.size() << std::endl;
         }
 
-        // Set plugin parameters
-        for (const auto& [paramName, value] : run.paramValues) {
-            setParameterValue(plugin, paramMap, paramName, value);
+        runSampleRate = run.sampleRate > 0.0 ? run.sampleRate : sampleRate;
+
+        // Equivalent discrete setting: the source run's output as it was measured
+        if (run.sourceRunId >= 0) {
+            auto source = sourceRecordings.find(run.sourceRunId);
+            if (source != sourceRecordings.end()) {
+                replayRecording(source->second, run, 1.0f);
+                if (lastDuplicate[run.sourceRunId] == runIndex)
+                    sourceRecordings.erase(source);
+                continue;
+            }
+        }
+        const bool isSource = lastDuplicate.count(run.runId) > 0;
+
+        const bool groupStart = runIndex == 0 || !sameSetting(runs[runIndex - 1], run);
+        if (replayGroup && !groupStart) {
+            // Linear setting: the reference run scaled to this run's input gain
+            const float scale = std::pow(10.0f, (run.inputGainDb - recordingGainDb) / 20.0f);
+            replayRecording(recording, run, scale);
+            if (isSource)
+                sourceRecordings[run.runId] = recording.scaledBy(scale);
+            continue;
+        }
+
+        // The instance prepared for this run's host configuration
+        const int runBlockSize = run.blockSize > 0 ? run.blockSize : blockSize;
+        const bool runDouble = usesDouble(run);
+        auto& instance = instances.get(runSampleRate, runBlockSize, runDouble);
+        auto& runPlugin = *instance.plugin;
+        const auto runSamples = (int64_t)std::llround((double)totalSamples * runSampleRate / sampleRate);
+        if (runSampleRate != automationSampleRate) {
+            automationSampleRate = runSampleRate;
+            automation = AutomationSchedule(config.automation, automationSampleRate, config.automationRampStepSamples);
+        }
+        const auto& automatedParams = instance.automatedParams;
+
+        // Set plugin parameters that changed since the instance's previous run. Automated parameters are
+        // reset from automationStart below, so the automation does not leave the setter out of date.
+        for (size_t p = 0; p < paramNames.size(); ++p) {
+            auto it = run.paramValues.find(paramNames[p]);
+            runParamValues[p] = it != run.paramValues.end() ? it->second : std::numeric_limits<float>::quiet_NaN();
+        }
+        instance.parameterSetter->apply(runParamValues);
+
+        bool recordRun = false;
+        replayGroup = false;
+        if (checkLinear && groupStart) {
+            size_t groupEnd = runIndex + 1;
+            float lowGainDb = run.inputGainDb, highGainDb = run.inputGainDb;
+            while (groupEnd < runs.size() && sameSetting(runs[groupEnd], run)) {
+                lowGainDb = std::min(lowGainDb, runs[groupEnd].inputGainDb);
+                highGainDb = std::max(highGainDb, runs[groupEnd].inputGainDb);
+                ++groupEnd;
+            }
+
+            if (groupEnd - runIndex > 1) {
+                const auto probeSamples = (int64_t)(config.linearityProbeSeconds * runSampleRate);
+                const auto result = checkLinearity(runPlugin, runBlockSize, probeSamples, lowGainDb, highGainDb,
+                                                   config.linearityToleranceDb,
+                                                   deriveRunSeed((uint64_t)(uint32_t)config.seed, run.runId));
+                replayGroup = recordRun = result.linear;
+                recording.clear();
+                recordingGainDb = run.inputGainDb;
+
+                if (linearityFile) {
+                    auto& out = *linearityFile;
+                    out << run.runId << "," << result.homogeneityErrorDb << "," << result.superpositionErrorDb
+                        << "," << (result.linear ? 1 : 0) << "," << (result.linear ? groupEnd - runIndex - 1 : 0);
+                    for (const auto& paramName : paramNames) {
+                        float value = 0.0f;
+                        auto it = run.paramValues.find(paramName);
+                        if (it != run.paramValues.end())
+                            value = it->second;
+                        out << "," << value;
+                    }
+                    out << "\n";
+                }
+            }
+        }
+
+        if (!automation.isEmpty()) {
+            automationStart = instance.automatedDefaults;
+            for (const auto& [paramName, value] : run.paramValues) {
+                for (size_t p = 0; p < automatedParams.size(); ++p) {
+                    if (automation.getParameterNames()[p].equalsIgnoreCase(paramName.trim()))
+                        automationStart[p] = value;
+                }
+            }
+            automation.reset(automationStart);
+            for (size_t p = 0; p < automatedParams.size(); ++p) {
+                if (automatedParams[p] != nullptr)
+                    automatedParams[p]->setValueNotifyingHost(automationStart[p]);
+            }
         }
 
         // Convert input gain from dB to linear amplitude
@@ -144,84 +912,184 @@ void runMeasurementGrid(juce::AudioPluginInstance& plugin, double sampleRate, in
         std::unique_ptr<SineGenerator> sineGen;
         std::unique_ptr<NoiseGenerator> noiseGen;
         std::unique_ptr<SweepGenerator> sweepGen;
+        std::unique_ptr<MultiToneGenerator> multiToneGen;
+        std::unique_ptr<MlsGenerator> mlsGen;
+        std::unique_ptr<StaircaseGenerator> staircaseGen;
 
         if (config.signalType.equalsIgnoreCase("sine")) {
             sineGen = std::make_unique<SineGenerator>();
-            sineGen->sampleRate = sampleRate;
+            sineGen->sampleRate = runSampleRate;
             sineGen->frequency = config.sineFrequency;
             sineGen->amplitude = inputGainLinear;
         } else if (config.signalType.equalsIgnoreCase("noise")) {
             noiseGen = std::make_unique<NoiseGenerator>();
             noiseGen->amplitude = inputGainLinear;
+            noiseGen->seed = deriveRunSeed((uint64_t)(uint32_t)config.seed, config.seedPerRun ? run.runId : 0);
+            noiseGen->reset();
         } else if (config.signalType.equalsIgnoreCase("sweep")) {
             sweepGen = std::make_unique<SweepGenerator>();
-            sweepGen->sampleRate = sampleRate;
+            sweepGen->sampleRate = runSampleRate;
             sweepGen->startHz = config.sweepStartHz;
             sweepGen->endHz = config.sweepEndHz;
             sweepGen->duration = config.seconds;
             sweepGen->amplitude = inputGainLinear;
             sweepGen->reset();
+        } else if (config.signalType.equalsIgnoreCase("multitone")) {
+            multiToneGen = std::make_unique<MultiToneGenerator>();
+            multiToneGen->sampleRate = runSampleRate;
+            multiToneGen->amplitude = inputGainLinear;
+            multiToneGen->tones =
+                MultiToneGenerator::buildTones(config.multiTonePreset, config.multiToneStartHz, config.multiToneEndHz,
+                                               config.multiToneCount, multiToneGen->periodLength, runSampleRate);
+            multiToneGen->reset();
+        } else if (config.signalType.equalsIgnoreCase("mls")) {
+            mlsGen = std::make_unique<MlsGenerator>();
+            mlsGen->order = config.mlsOrder;
+            mlsGen->amplitude = inputGainLinear;
+            mlsGen->reset();
+        } else if (config.signalType.equalsIgnoreCase("staircase")) {
+            staircaseGen = std::make_unique<StaircaseGenerator>();
+            staircaseGen->sampleRate = runSampleRate;
+            staircaseGen->frequency = config.sineFrequency;
+            staircaseGen->duration = config.seconds;
+            staircaseGen->amplitude = inputGainLinear;
+            staircaseGen->stepsDb = getStaircaseSteps(config);
+            staircaseGen->reset();
         }
 
-        // Process samples
-        int64_t currentSample = 0;
-        int blockCount = 0;
-        while (currentSample < totalSamples) {
-            int numThisBlock = (int)std::min((int64_t)blockSize, totalSamples - currentSample);
-            blockCount++;
-            if (blockCount % 1000 == 0) {
-                std::cerr << "[runMeasurementGrid] Run " << run.runId << ": processed " << currentSample << " / "
-                          << totalSamples << " samples" << std::endl;
+        auto fillInput = [&](auto& buffer, int numSamples) {
+            if (sineGen) {
+                sineGen->fillBlock(buffer, numSamples);
+            } else if (noiseGen) {
+                noiseGen->fillBlock(buffer, numSamples);
+            } else if (sweepGen) {
+                sweepGen->fillBlock(buffer, numSamples);
+            } else if (multiToneGen) {
+                multiToneGen->fillBlock(buffer, numSamples);
+            } else if (mlsGen) {
+                mlsGen->fillBlock(buffer, numSamples);
+            } else if (staircaseGen) {
+                staircaseGen->fillBlock(buffer, numSamples);
             }
+        };
+
+        // Output alignment: the plugin runs `alignment` samples ahead of the analyzers. The pre-roll feeds the
+        // start of the stimulus through the plugin (discarding its output) and into a delay line, so the
+        // analyzers still see the stimulus from sample 0, paired with the output it produced.
+        const int reportedLatency = runPlugin.getLatencySamples();
+        int alignment = 0;
+        if (config.alignOutput)
+            alignment = std::max(0, config.alignmentSamples >= 0 ? config.alignmentSamples : reportedLatency);
+
+        recording.reportedLatency = reportedLatency;
+        recording.alignment = alignment;
+
+        RunRecording* sourceRecording = nullptr;
+        if (isSource) {
+            sourceRecording = &sourceRecordings[run.runId];
+            sourceRecording->clear();
+            sourceRecording->reportedLatency = reportedLatency;
+            sourceRecording->alignment = alignment;
+        }
+
+        AlignmentDelay alignmentDelay(inputBuffer.getNumChannels(), alignment);
 
+        // Renders the next block of the stimulus into `input` and runs it through the plugin into `output`, in
+        // the buffers' precision; returns the time the plugin's processBlock took
+        auto renderBlock = [&](auto& input, auto& output, int numSamples) {
             // Clear buffers
-            inputBuffer.clear();
-            outputBuffer.clear();
+            input.clear();
+            output.clear();
 
-            // Fill input with test signal
-            if (sineGen) {
-                sineGen->fillBlock(inputBuffer, numThisBlock);
-            } else if (noiseGen) {
-                noiseGen->fillBlock(inputBuffer, numThisBlock);
-            } else if (sweepGen) {
-                sweepGen->fillBlock(inputBuffer, numThisBlock);
+            // Fill input with test signal; the sidechain channels get it at their own level
+            fillInput(input, numSamples);
+            for (int ch = bus.inputs; ch < bus.inputs + bus.sidechain; ++ch) {
+                auto* data = input.getWritePointer(ch);
+                for (int i = 0; i < numSamples; ++i)
+                    data[i] *= sidechainGain;
             }
 
-            // Copy input to output buffer (processBlock works in-place)
-            outputBuffer.makeCopyOf(inputBuffer);
+            // Copy input to the plugin's input channels, main bus then sidechain (processBlock works in-place)
+            for (int ch = 0; ch < bus.mainInputs; ++ch)
+                output.copyFrom(ch, 0, input, ch, 0, numSamples);
+            for (int ch = 0; ch < bus.sidechain; ++ch)
+                output.copyFrom(bus.mainInputs + ch, 0, input, bus.inputs + ch, 0, numSamples);
 
-            // Process through plugin (modifies outputBuffer in-place)
-            plugin.processBlock(outputBuffer, midiBuffer);
+            // Process through plugin (modifies output in-place), sized to this block so a short final or
+            // pre-roll block does not advance the plugin's state past the stimulus
+            std::decay_t<decltype(output)> pluginBlock(output.getArrayOfWritePointers(), output.getNumChannels(),
+                                                       numSamples);
+            const auto processStart = std::chrono::steady_clock::now();
+            runPlugin.processBlock(pluginBlock, midiBuffer);
+            const auto processEnd = std::chrono::steady_clock::now();
 
-            // Build BlockContext
-            BlockContext ctx;
-            ctx.firstSample = currentSample;
-            ctx.sampleRate = sampleRate;
-            ctx.numSamples = numThisBlock;
-            ctx.inL = inputBuffer.getReadPointer(0);
-            ctx.inR = inputBuffer.getNumChannels() > 1 ? inputBuffer.getReadPointer(1) : nullptr;
-            ctx.outL = outputBuffer.getReadPointer(0);
-            ctx.outR = outputBuffer.getNumChannels() > 1 ? outputBuffer.getReadPointer(1) : nullptr;
-            ctx.runId = run.runId;
-            ctx.paramNamedValues = run.paramValues;
-            ctx.inputGainDb = run.inputGainDb;
+            // Analyzers see the input from `alignment` samples ago
+            alignmentDelay.process(input, numSamples);
+            return std::chrono::duration<double>(processEnd - processStart).count();
+        };
 
-            // Build params vector in fixed order
-            for (const auto& paramName : paramNames) {
-                float value = 0.0f;
-                auto it = run.paramValues.find(paramName);
-                if (it != run.paramValues.end())
-                    value = it->second;
-                ctx.params.push_back(value);
+        for (int preRolled = 0; preRolled < alignment;) {
+            const int numThisBlock = std::min(runBlockSize, alignment - preRolled);
+            if (runDouble)
+                renderBlock(inputBufferDouble, outputBufferDouble, numThisBlock);
+            else
+                renderBlock(inputBuffer, outputBuffer, numThisBlock);
+            preRolled += numThisBlock;
+        }
+
+        // Process samples
+        blockSchedule.reset(runBlockSize);
+        int64_t currentSample = 0;
+        int blockCount = 0;
+        double runProcessSeconds = 0.0;
+        while (currentSample < runSamples) {
+            int numThisBlock = (int)std::min((int64_t)blockSchedule.next(), runSamples - currentSample);
+
+            // Apply automation due at this sample and end the block where the next value change is due
+            int parameterChanges = 0;
+            if (!automation.isEmpty()) {
+                automation.update(currentSample, changedParams);
+                for (int p : changedParams) {
+                    if (automatedParams[p] != nullptr)
+                        automatedParams[p]->setValueNotifyingHost(automation.getValues()[p]);
+                }
+                parameterChanges = (int)changedParams.size();
+                numThisBlock =
+                    (int)std::min<int64_t>(numThisBlock, automation.nextChange(currentSample) - currentSample);
+            }
+            blockCount++;
+            if (blockCount % 1000 == 0) {
+                std::cerr << "[runMeasurementGrid] Run " << run.runId << ": processed " << currentSample << " / "
+                          << runSamples << " samples" << std::endl;
             }
 
-            // Process through analyzers
-            for (auto& analyzer : analyzers) {
-                analyzer->processBlock(ctx);
+            double processSeconds = 0.0;
+            if (runDouble) {
+                processSeconds = renderBlock(inputBufferDouble, outputBufferDouble, numThisBlock);
+                convertBlock(inputBufferDouble, inputBuffer, bus.inputs + bus.sidechain, numThisBlock);
+                convertBlock(outputBufferDouble, outputBuffer, bus.outputs, numThisBlock);
+            } else {
+                processSeconds = renderBlock(inputBuffer, outputBuffer, numThisBlock);
+            }
+
+            runProcessSeconds += processSeconds;
+            analyzeBlock(run, currentSample, numThisBlock, reportedLatency, alignment, parameterChanges,
+                         processSeconds, true);
+            if (runDouble) {
+                if (recordRun)
+                    recording.append(inputBufferDouble, outputBufferDouble, bus.outputs, numThisBlock);
+                if (sourceRecording != nullptr)
+                    sourceRecording->append(inputBufferDouble, outputBufferDouble, bus.outputs, numThisBlock);
+            } else {
+                if (recordRun)
+                    recording.append(inputBuffer, outputBuffer, bus.outputs, numThisBlock);
+                if (sourceRecording != nullptr)
+                    sourceRecording->append(inputBuffer, outputBuffer, bus.outputs, numThisBlock);
             }
 
             currentSample += numThisBlock;
         }
+        writeHostRow(run, runBlockSize, reportedLatency, true, runProcessSeconds, runSamples);
     }
 
     // Finish all analyzers
@@ -3,12 +3,19 @@
 #include "Analyzer.h"
 #include "Config.h"
 #include "JuceHeader.h"
+#include "PluginLoader.h"
 #include "RunConfig.h"
 #include "SignalGenerator.h"
 #include <memory>
 #include <vector>
 
-std::vector<RunConfig> buildRunGrid(const Config& config, const std::vector<juce::String>& paramNames);
+// Bus layout for loadPluginInstance(): inputChannels, outputChannels and whether the sidechain is used
+BusLayoutRequest getBusLayoutRequest(const Config& config);
+
+// With a plugin (and config.dedupeDiscrete), combinations that only differ in discrete parameters by values
+// snapping to the same step are measured once: the equivalent runs get sourceRunId and follow their source.
+std::vector<RunConfig> buildRunGrid(const Config& config, const std::vector<juce::String>& paramNames,
+                                    juce::AudioPluginInstance* plugin = nullptr);
 
 void runMeasurementGrid(juce::AudioPluginInstance& plugin, double sampleRate, int blockSize, int64_t totalSamples,
                         const std::vector<RunConfig>& runs, const std::vector<std::unique_ptr<Analyzer>>& analyzers,
@@ -0,0 +1,273 @@
+#include "MlsAnalyzer.h"
+#include "SignalGenerator.h"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <iostream>
+
+MlsAnalyzer::MlsAnalyzer(const juce::File& outDir, int order, const std::vector<juce::String>& paramNames,
+                         const juce::String& signalType)
+    : order(std::clamp(order, MlsGenerator::minOrder, MlsGenerator::maxOrder)), paramNames(paramNames),
+      signalType(signalType) {
+    juce::String responseName = "grid_mls_response_" + signalType.toLowerCase() + ".csv";
+    responseFile = std::make_unique<std::ofstream>(outDir.getChildFile(responseName).getFullPathName().toStdString());
+    if (!responseFile->is_open()) {
+        std::cerr << "Failed to open " << responseName.toStdString() << " for writing" << std::endl;
+        responseFile.reset();
+    }
+
+    juce::String irName = "grid_mls_ir_" + signalType.toLowerCase() + ".csv";
+    irFile = std::make_unique<std::ofstream>(outDir.getChildFile(irName).getFullPathName().toStdString());
+    if (!irFile->is_open()) {
+        std::cerr << "Failed to open " << irName.toStdString() << " for writing" << std::endl;
+        irFile.reset();
+    }
+
+    // Headers
+    if (responseFile) {
+        *responseFile << "runId,freqHz,magDb,phaseDeg,groupDelayMs,numPeriods";
+        for (const auto& paramName : paramNames)
+            *responseFile << "," << paramName.toStdString();
+        *responseFile << ",inputGainDb\n";
+    }
+
+    if (irFile) {
+        *irFile << "runId,sample,timeMs,ir";
+        for (const auto& paramName : paramNames)
+            *irFile << "," << paramName.toStdString();
+        *irFile << ",inputGainDb\n";
+    }
+
+    // Same sequence the generator plays
+    std::vector<uint8_t> bits;
+    std::vector<uint32_t> states;
+    MlsGenerator::generate(this->order, bits, states);
+    sequenceLength = (int)bits.size();
+
+    // Sample n of the sequence maps to Hadamard row states[n]. Lag k maps to the column whose bit j is
+    // the sequence bit k samples before the step where the register held only bit j.
+    std::vector<int> stepOfUnitState(this->order, 0);
+    for (int n = 0; n < sequenceLength; ++n) {
+        const uint32_t state = states[n];
+        if ((state & (state - 1)) == 0) {
+            int j = 0;
+            while ((1u << j) != state)
+                ++j;
+            stepOfUnitState[j] = n;
+        }
+    }
+
+    inputIndex.assign(states.begin(), states.end());
+    outputIndex.assign(sequenceLength, 0);
+    for (int k = 0; k < sequenceLength; ++k) {
+        uint32_t index = 0;
+        for (int j = 0; j < this->order; ++j) {
+            const int n = (stepOfUnitState[j] - k + sequenceLength) % sequenceLength;
+            index |= (uint32_t)bits[n] << j;
+        }
+        outputIndex[k] = index;
+    }
+    hadamardScratch.assign(sequenceLength + 1, 0.0);
+
+    // Impulse response window: half-Hann fade-in before time zero, half-Hann fade-out on the last quarter
+    irLength = std::min(4096, (sequenceLength + 1) / 2);
+    irPreSamples = irLength / 16;
+
+    int irOrder = 0;
+    while ((1 << irOrder) < irLength)
+        ++irOrder;
+    irFft = std::make_unique<juce::dsp::FFT>(irOrder);
+
+    irWindow.assign(irLength, 1.0f);
+    const int fadeOut = irLength / 4;
+    for (int i = 0; i < irPreSamples; ++i)
+        irWindow[i] = 0.5f * (1.0f - std::cos(juce::MathConstants<float>::pi * (float)i / (float)irPreSamples));
+    for (int i = 0; i < fadeOut; ++i)
+        irWindow[irLength - fadeOut + i] =
+            0.5f * (1.0f + std::cos(juce::MathConstants<float>::pi * (float)i / (float)fadeOut));
+}
+
+MlsAnalyzer::~MlsAnalyzer() {}
+
+void MlsAnalyzer::completePeriod() {
+    auto& run = current;
+
+    // The first period absorbs the plugin's settling; drop it once a later period is available
+    if (run.holdsSettlingPeriod) {
+        std::fill(run.sumIn.begin(), run.sumIn.end(), 0.0);
+        std::fill(run.sumOut.begin(), run.sumOut.end(), 0.0);
+        run.numPeriods = 0;
+        run.holdsSettlingPeriod = false;
+    } else if (run.numPeriods == 0) {
+        run.holdsSettlingPeriod = true;
+    }
+
+    for (int n = 0; n < sequenceLength; ++n) {
+        run.sumIn[n] += (double)run.periodIn[n];
+        run.sumOut[n] += (double)run.periodOut[n];
+    }
+    run.numPeriods++;
+    run.position = 0;
+}
+
+void MlsAnalyzer::correlate(const std::vector<double>& period, int numPeriods,
+                            std::vector<double>& impulseResponse) {
+    // Scatter into Hadamard order (row 0 is unused by the sequence)
+    auto& z = hadamardScratch;
+    z[0] = 0.0;
+    for (int n = 0; n < sequenceLength; ++n)
+        z[inputIndex[n]] = period[n] / (double)numPeriods;
+
+    // In-place fast Walsh-Hadamard transform: additions and subtractions only
+    const int size = sequenceLength + 1;
+    for (int half = 1; half < size; half *= 2) {
+        for (int block = 0; block < size; block += 2 * half) {
+            for (int i = block; i < block + half; ++i) {
+                const double a = z[i];
+                const double b = z[i + half];
+                z[i] = a + b;
+                z[i + half] = a - b;
+            }
+        }
+    }
+
+    // Gather the circular correlation r[k]. With the MLS autocorrelation (L at lag 0, -1 elsewhere),
+    // r[k] = (L + 1) h[k] - sum(h) and sum(r) = sum(h).
+    impulseResponse.resize(sequenceLength);
+    double sum = 0.0;
+    for (int k = 0; k < sequenceLength; ++k) {
+        impulseResponse[k] = z[outputIndex[k]];
+        sum += impulseResponse[k];
+    }
+    for (auto& h : impulseResponse)
+        h = (h + sum) / (double)size;
+}
+
+void MlsAnalyzer::writeParams(std::ostream& out, const RunCapture& run) const {
+    for (const auto& paramName : paramNames) {
+        float value = 0.0f;
+        auto it = run.paramValues.find(paramName);
+        if (it != run.paramValues.end())
+            value = it->second;
+        out << "," << value;
+    }
+    out << "," << run.inputGainDb << "\n";
+}
+
+void MlsAnalyzer::processRun() {
+    if (current.numPeriods == 0 || (!responseFile && !irFile))
+        return;
+
+    // The input correlates to a single impulse of the stimulus amplitude; use it to normalise the output
+    std::vector<double> inIr, outIr;
+    correlate(current.sumIn, current.numPeriods, inIr);
+    correlate(current.sumOut, current.numPeriods, outIr);
+    const double reference = inIr[0];
+    if (std::abs(reference) <= 0.0)
+        return;
+
+    // Windowed impulse response; the samples before time zero wrap around from the end of the period
+    std::vector<float> scratch(2 * irLength, 0.0f);
+    for (int i = 0; i < irLength; ++i) {
+        const int n = (i - irPreSamples + sequenceLength) % sequenceLength;
+        scratch[i] = (float)(outIr[n] / reference) * irWindow[i];
+    }
+
+    const double sampleRate = current.sampleRate;
+
+    if (irFile) {
+        auto& out = *irFile;
+        for (int i = 0; i < irLength; ++i) {
+            const int sample = i - irPreSamples;
+            out << current.runId << "," << sample << "," << 1000.0 * (double)sample / sampleRate << ","
+                << scratch[i];
+            writeParams(out, current);
+        }
+    }
+
+    if (!responseFile)
+        return;
+
+    irFft->performRealOnlyForwardTransform(scratch.data(), true);
+
+    // Undo the pre-roll so phase and group delay refer to time zero
+    const int numBins = irLength / 2;
+    const double twoPi = 2.0 * juce::MathConstants<double>::pi;
+    std::vector<std::complex<double>> H(numBins);
+    for (int k = 0; k < numBins; ++k) {
+        const double shift = twoPi * (double)k * (double)irPreSamples / (double)irLength;
+        H[k] = std::complex<double>(scratch[2 * k], scratch[2 * k + 1]) * std::polar(1.0, shift);
+    }
+
+    const double binHz = sampleRate / (double)irLength;
+    auto& out = *responseFile;
+    for (int k = 1; k < numBins; ++k) {
+        const double magDb = 20.0 * std::log10(std::max(std::abs(H[k]), 1e-10));
+        const double phaseDeg = std::arg(H[k]) * 180.0 / juce::MathConstants<double>::pi;
+
+        // Group delay -dphi/domega from the wrapped phase difference of neighbouring bins
+        const int kLo = k - 1;
+        const int kHi = std::min(numBins - 1, k + 1);
+        const double dPhi = std::arg(H[kHi] * std::conj(H[kLo]));
+        const double dOmega = twoPi * binHz * (double)(kHi - kLo);
+        const double groupDelayMs = -dPhi / dOmega * 1000.0;
+
+        out << current.runId << "," << (double)k * binHz << "," << magDb << "," << phaseDeg << "," << groupDelayMs
+            << "," << current.numPeriods;
+        writeParams(out, current);
+    }
+}
+
+void MlsAnalyzer::processBlock(const BlockContext& ctx) {
+    // A new run id means the previous run is complete
+    if (ctx.runId != current.runId) {
+        if (current.runId >= 0)
+            processRun();
+
+        current.runId = ctx.runId;
+        current.paramValues = ctx.paramNamedValues;
+        current.inputGainDb = ctx.inputGainDb;
+        current.sampleRate = ctx.sampleRate;
+        current.periodIn.assign(sequenceLength, 0.0f);
+        current.periodOut.assign(sequenceLength, 0.0f);
+        current.sumIn.assign(sequenceLength, 0.0);
+        current.sumOut.assign(sequenceLength, 0.0);
+        current.position = 0;
+        current.numPeriods = 0;
+        current.holdsSettlingPeriod = false;
+    }
+
+    int i = 0;
+    while (i < ctx.numSamples) {
+        const int toCopy = std::min(ctx.numSamples - i, sequenceLength - current.position);
+        std::copy(ctx.inL + i, ctx.inL + i + toCopy, current.periodIn.begin() + current.position);
+        std::copy(ctx.outL + i, ctx.outL + i + toCopy, current.periodOut.begin() + current.position);
+        current.position += toCopy;
+        i += toCopy;
+
+        if (current.position >= sequenceLength)
+            completePeriod();
+    }
+}
+
+void MlsAnalyzer::finish(const juce::File& outDir) {
+    if (current.runId >= 0) {
+        processRun();
+        current.runId = -1;
+    }
+
+    if (responseFile) {
+        responseFile->close();
+        responseFile.reset();
+    }
+    if (irFile) {
+        irFile->close();
+        irFile.reset();
+    }
+}
+
+std::unique_ptr<Analyzer> createMlsAnalyzer(const juce::File& outDir, int order,
+                                            const std::vector<juce::String>& paramNames,
+                                            const juce::String& signalType) {
+    return std::make_unique<MlsAnalyzer>(outDir, order, paramNames, signalType);
+}
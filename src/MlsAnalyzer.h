@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Analyzer.h"
+#include "JuceHeader.h"
+#include <fstream>
+#include <map>
+#include <memory>
+#include <vector>
+
+// Impulse response analyzer for the periodic MlsGenerator stimulus.
+// Whole MLS periods of input and output are averaged (the first is dropped as settling time when more
+// are available), then the circular cross-correlation with the sequence is computed with a fast Hadamard
+// transform: the averaged period is scattered into Hadamard order using the LFSR states, transformed with
+// additions only, and gathered back. The output response is normalised by the input's own correlation
+// peak, giving the impulse response plus magnitude, phase and group delay from a single FFT of it.
+struct MlsAnalyzer : public Analyzer {
+    MlsAnalyzer(const juce::File& outDir, int order, const std::vector<juce::String>& paramNames,
+                const juce::String& signalType);
+    ~MlsAnalyzer() override;
+
+    void processBlock(const BlockContext& ctx) override;
+    void finish(const juce::File& outDir) override;
+
+private:
+    struct RunCapture {
+        int runId = -1;
+        std::vector<float> periodIn; // period currently being captured
+        std::vector<float> periodOut;
+        std::vector<double> sumIn; // sum of completed periods
+        std::vector<double> sumOut;
+        int position = 0;
+        int numPeriods = 0;
+        bool holdsSettlingPeriod = false;
+        std::map<juce::String, float> paramValues;
+        float inputGainDb = 0.0f;
+        double sampleRate = 48000.0;
+    };
+
+    RunCapture current;
+    int order;
+    int sequenceLength;
+    std::vector<juce::String> paramNames;
+    juce::String signalType;
+
+    std::unique_ptr<std::ofstream> responseFile;
+    std::unique_ptr<std::ofstream> irFile;
+
+    // Hadamard permutations: sample n scatters to inputIndex[n], lag k gathers from outputIndex[k]
+    std::vector<uint32_t> inputIndex;
+    std::vector<uint32_t> outputIndex;
+    std::vector<double> hadamardScratch;
+
+    int irLength;
+    int irPreSamples;
+    std::vector<float> irWindow;
+    std::unique_ptr<juce::dsp::FFT> irFft;
+
+    void completePeriod();
+    void correlate(const std::vector<double>& period, int numPeriods, std::vector<double>& impulseResponse);
+    void processRun();
+    void writeParams(std::ostream& out, const RunCapture& run) const;
+};
+
+std::unique_ptr<Analyzer> createMlsAnalyzer(const juce::File& outDir, int order,
+                                            const std::vector<juce::String>& paramNames,
+                                            const juce::String& signalType);
@@ -0,0 +1,246 @@
+#include "MultiToneAnalyzer.h"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <iostream>
+
+MultiToneAnalyzer::MultiToneAnalyzer(const juce::File& outDir, const juce::String& preset, double startHz,
+                                     double endHz, int numTones, int periodLength,
+                                     const std::vector<juce::String>& paramNames, const juce::String& signalType)
+    : preset(preset), startHz(startHz), endHz(endHz), numTones(numTones), periodLength(periodLength),
+      paramNames(paramNames), signalType(signalType) {
+    juce::String toneName = "grid_multitone_" + signalType.toLowerCase() + ".csv";
+    toneFile = std::make_unique<std::ofstream>(outDir.getChildFile(toneName).getFullPathName().toStdString());
+    if (!toneFile->is_open()) {
+        std::cerr << "Failed to open " << toneName.toStdString() << " for writing" << std::endl;
+        toneFile.reset();
+    }
+
+    juce::String imdName = "grid_imd_" + signalType.toLowerCase() + ".csv";
+    imdFile = std::make_unique<std::ofstream>(outDir.getChildFile(imdName).getFullPathName().toStdString());
+    if (!imdFile->is_open()) {
+        std::cerr << "Failed to open " << imdName.toStdString() << " for writing" << std::endl;
+        imdFile.reset();
+    }
+
+    // Headers
+    if (toneFile) {
+        *toneFile << "runId,toneIndex,freqHz,magDb,phaseDeg";
+        for (const auto& paramName : paramNames)
+            *toneFile << "," << paramName.toStdString();
+        *toneFile << ",inputGainDb\n";
+    }
+
+    if (imdFile) {
+        *imdFile << "runId,preset,distortionDb,imd,imd2,imd3";
+        for (const auto& paramName : paramNames)
+            *imdFile << "," << paramName.toStdString();
+        *imdFile << ",inputGainDb\n";
+    }
+}
+
+MultiToneAnalyzer::~MultiToneAnalyzer() {}
+
+void MultiToneAnalyzer::prepare(double sampleRate) {
+    preparedSampleRate = sampleRate;
+    tones = MultiToneGenerator::buildTones(preset, startHz, endHz, numTones, periodLength, sampleRate);
+
+    int order = 0;
+    while ((1 << order) < periodLength)
+        ++order;
+    fft = std::make_unique<juce::dsp::FFT>(order);
+}
+
+void MultiToneAnalyzer::completePeriod() {
+    auto& run = current;
+
+    // The first period absorbs the plugin's settling; drop it once a later period is available
+    if (run.holdsSettlingPeriod) {
+        std::fill(run.sumIn.begin(), run.sumIn.end(), 0.0);
+        std::fill(run.sumOut.begin(), run.sumOut.end(), 0.0);
+        run.numPeriods = 0;
+        run.holdsSettlingPeriod = false;
+    } else if (run.numPeriods == 0) {
+        run.holdsSettlingPeriod = true;
+    }
+
+    for (int n = 0; n < periodLength; ++n) {
+        run.sumIn[n] += (double)run.periodIn[n];
+        run.sumOut[n] += (double)run.periodOut[n];
+    }
+    run.numPeriods++;
+    run.position = 0;
+}
+
+void MultiToneAnalyzer::writeParams(std::ostream& out, const RunCapture& run) const {
+    for (const auto& paramName : paramNames) {
+        float value = 0.0f;
+        auto it = run.paramValues.find(paramName);
+        if (it != run.paramValues.end())
+            value = it->second;
+        out << "," << value;
+    }
+    out << "," << run.inputGainDb << "\n";
+}
+
+void MultiToneAnalyzer::processRun() {
+    if (current.numPeriods == 0 || tones.empty())
+        return;
+
+    // Spectra of the averaged period
+    std::vector<float> inScratch(2 * periodLength, 0.0f);
+    std::vector<float> outScratch(2 * periodLength, 0.0f);
+    for (int n = 0; n < periodLength; ++n) {
+        inScratch[n] = (float)(current.sumIn[n] / current.numPeriods);
+        outScratch[n] = (float)(current.sumOut[n] / current.numPeriods);
+    }
+    fft->performRealOnlyForwardTransform(inScratch.data(), true);
+    fft->performRealOnlyForwardTransform(outScratch.data(), true);
+
+    const int numBins = periodLength / 2;
+    auto inBin = [&](int k) { return std::complex<double>(inScratch[2 * k], inScratch[2 * k + 1]); };
+    auto outBin = [&](int k) { return std::complex<double>(outScratch[2 * k], outScratch[2 * k + 1]); };
+    auto outAmplitude = [&](int k) {
+        return (k > 0 && k < numBins) ? 2.0 * std::abs(outBin(k)) / (double)periodLength : 0.0;
+    };
+
+    const double binHz = preparedSampleRate / (double)periodLength;
+
+    // Per-tone gain and phase
+    if (toneFile) {
+        for (size_t t = 0; t < tones.size(); ++t) {
+            const int k = tones[t].bin;
+            const std::complex<double> X = inBin(k);
+            if (std::abs(X) <= 0.0)
+                continue;
+
+            const std::complex<double> H = outBin(k) / X;
+            *toneFile << current.runId << "," << t << "," << (double)k * binHz << ","
+                      << 20.0 * std::log10(std::max(std::abs(H), 1e-10)) << ","
+                      << std::arg(H) * 180.0 / juce::MathConstants<double>::pi;
+            writeParams(*toneFile, current);
+        }
+    }
+
+    if (!imdFile)
+        return;
+
+    // Everything that is not a stimulus tone (or DC) counts as distortion
+    std::vector<bool> isTone(numBins, false);
+    double tonePower = 0.0;
+    for (const auto& tone : tones) {
+        isTone[tone.bin] = true;
+        tonePower += std::norm(outBin(tone.bin));
+    }
+
+    double residualPower = 0.0;
+    for (int k = 1; k < numBins; ++k) {
+        if (!isTone[k])
+            residualPower += std::norm(outBin(k));
+    }
+
+    double distortionDb = 0.0;
+    if (tonePower > 0.0)
+        distortionDb = 10.0 * std::log10(std::max(residualPower / tonePower, 1e-20));
+
+    *imdFile << current.runId << "," << preset << "," << distortionDb << ",";
+
+    if (tones.size() == 2 && (preset.equalsIgnoreCase("smpte") || preset.equalsIgnoreCase("ccif"))) {
+        const int b1 = std::min(tones[0].bin, tones[1].bin);
+        const int b2 = std::max(tones[0].bin, tones[1].bin);
+        double imd = 0.0, imd2 = 0.0, imd3 = 0.0;
+
+        if (preset.equalsIgnoreCase("smpte")) {
+            const double ref = outAmplitude(b2);
+            if (ref > 0.0) {
+                double sumSq = 0.0;
+                for (int n = 1; n <= 3; ++n) {
+                    const double lower = outAmplitude(b2 - n * b1);
+                    const double upper = outAmplitude(b2 + n * b1);
+                    const double orderSq = lower * lower + upper * upper;
+                    if (n == 1)
+                        imd2 = std::sqrt(orderSq) / ref;
+                    else if (n == 2)
+                        imd3 = std::sqrt(orderSq) / ref;
+                    sumSq += orderSq;
+                }
+                imd = std::sqrt(sumSq) / ref;
+            }
+        } else {
+            const double ref = outAmplitude(b1) + outAmplitude(b2);
+            if (ref > 0.0) {
+                const double d2 = outAmplitude(b2 - b1);
+                const double d3Low = outAmplitude(2 * b1 - b2);
+                const double d3High = outAmplitude(2 * b2 - b1);
+                imd2 = d2 / ref;
+                imd3 = std::sqrt(d3Low * d3Low + d3High * d3High) / ref;
+                imd = std::sqrt(imd2 * imd2 + imd3 * imd3);
+            }
+        }
+
+        *imdFile << imd << "," << imd2 << "," << imd3;
+    } else {
+        *imdFile << ",,";
+    }
+
+    writeParams(*imdFile, current);
+}
+
+void MultiToneAnalyzer::processBlock(const BlockContext& ctx) {
+    // A new run id means the previous run is complete
+    if (ctx.runId != current.runId) {
+        if (current.runId >= 0)
+            processRun();
+
+        // The tone set is chosen per sample rate, so rebuild it (and the period FFT) for the new run
+        if (ctx.sampleRate != preparedSampleRate)
+            prepare(ctx.sampleRate);
+
+        current.runId = ctx.runId;
+        current.paramValues = ctx.paramNamedValues;
+        current.inputGainDb = ctx.inputGainDb;
+        current.periodIn.assign(periodLength, 0.0f);
+        current.periodOut.assign(periodLength, 0.0f);
+        current.sumIn.assign(periodLength, 0.0);
+        current.sumOut.assign(periodLength, 0.0);
+        current.position = 0;
+        current.numPeriods = 0;
+        current.holdsSettlingPeriod = false;
+    }
+
+    int i = 0;
+    while (i < ctx.numSamples) {
+        const int toCopy = std::min(ctx.numSamples - i, periodLength - current.position);
+        std::copy(ctx.inL + i, ctx.inL + i + toCopy, current.periodIn.begin() + current.position);
+        std::copy(ctx.outL + i, ctx.outL + i + toCopy, current.periodOut.begin() + current.position);
+        current.position += toCopy;
+        i += toCopy;
+
+        if (current.position >= periodLength)
+            completePeriod();
+    }
+}
+
+void MultiToneAnalyzer::finish(const juce::File& outDir) {
+    if (current.runId >= 0) {
+        processRun();
+        current.runId = -1;
+    }
+
+    if (toneFile) {
+        toneFile->close();
+        toneFile.reset();
+    }
+    if (imdFile) {
+        imdFile->close();
+        imdFile.reset();
+    }
+}
+
+std::unique_ptr<Analyzer> createMultiToneAnalyzer(const juce::File& outDir, const juce::String& preset,
+                                                  double startHz, double endHz, int numTones, int periodLength,
+                                                  const std::vector<juce::String>& paramNames,
+                                                  const juce::String& signalType) {
+    return std::make_unique<MultiToneAnalyzer>(outDir, preset, startHz, endHz, numTones, periodLength, paramNames,
+                                               signalType);
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Analyzer.h"
+#include "JuceHeader.h"
+#include "SignalGenerator.h"
+#include <fstream>
+#include <map>
+#include <memory>
+#include <vector>
+
+// Multi-tone / intermodulation analyzer for the periodic MultiToneGenerator stimulus.
+// Input and output are synchronously averaged over whole stimulus periods (the first period is dropped
+// as settling time when more than one is available), then a single rectangular FFT of the averaged
+// period gives per-tone gain and phase, the residual distortion power between tones and, for the
+// two-tone presets, IMD:
+//   smpte - sidebands f2 +/- n*f1 (n = 1..3) relative to the f2 output amplitude
+//   ccif  - f2 - f1 (d2) and 2*f1 - f2, 2*f2 - f1 (d3) relative to the sum of both output amplitudes
+struct MultiToneAnalyzer : public Analyzer {
+    MultiToneAnalyzer(const juce::File& outDir, const juce::String& preset, double startHz, double endHz,
+                      int numTones, int periodLength, const std::vector<juce::String>& paramNames,
+                      const juce::String& signalType);
+    ~MultiToneAnalyzer() override;
+
+    void processBlock(const BlockContext& ctx) override;
+    void finish(const juce::File& outDir) override;
+
+private:
+    struct RunCapture {
+        int runId = -1;
+        std::vector<float> periodIn; // period currently being captured
+        std::vector<float> periodOut;
+        std::vector<double> sumIn; // sum of completed periods
+        std::vector<double> sumOut;
+        int position = 0;
+        int numPeriods = 0;
+        bool holdsSettlingPeriod = false;
+        std::map<juce::String, float> paramValues;
+        float inputGainDb = 0.0f;
+    };
+
+    RunCapture current;
+    juce::String preset;
+    double startHz;
+    double endHz;
+    int numTones;
+    int periodLength;
+    std::vector<juce::String> paramNames;
+    juce::String signalType;
+
+    std::unique_ptr<std::ofstream> toneFile;
+    std::unique_ptr<std::ofstream> imdFile;
+
+    double preparedSampleRate = 0.0;
+    std::vector<MultiToneGenerator::Tone> tones;
+    std::unique_ptr<juce::dsp::FFT> fft;
+
+    void prepare(double sampleRate);
+    void completePeriod();
+    void processRun();
+    void writeParams(std::ostream& out, const RunCapture& run) const;
+};
+
+std::unique_ptr<Analyzer> createMultiToneAnalyzer(const juce::File& outDir, const juce::String& preset,
+                                                  double startHz, double endHz, int numTones, int periodLength,
+                                                  const std::vector<juce::String>& paramNames,
+                                                  const juce::String& signalType);
@@ -0,0 +1,270 @@
+#include "ParameterChangeAnalyzer.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+ParameterChangeAnalyzer::ParameterChangeAnalyzer(const juce::File& outDir,
+                                                 const std::vector<AutomationEventConfig>& automation,
+                                                 int rampStepSamples, const std::vector<juce::String>& paramNames,
+                                                 const juce::String& signalType)
+    : automation(automation), rampStepSamples(rampStepSamples), paramNames(paramNames), signalType(signalType) {
+    // Event sample positions depend on the sample rate and are rebuilt in prepare(); the names do not
+    const auto automatedNames = AutomationSchedule(automation, 48000.0, rampStepSamples).getParameterNames();
+
+    juce::String eventsName = "grid_parameter_changes_" + signalType.toLowerCase() + ".csv";
+    eventsFile = std::make_unique<std::ofstream>(outDir.getChildFile(eventsName).getFullPathName().toStdString());
+    if (!eventsFile->is_open()) {
+        std::cerr << "Failed to open " << eventsName.toStdString() << " for writing" << std::endl;
+        eventsFile.reset();
+    } else {
+        *eventsFile << "runId,event,paramName,fromValue,value,timeMs,rampMs,gainBeforeDb,gainAfterDb,gainChangeDb,"
+                       "settlingMs,overshootDb,parameterChanges,cpuPerChangeUs";
+        for (const auto& paramName : paramNames)
+            *eventsFile << "," << paramName.toStdString();
+        *eventsFile << ",inputGainDb\n";
+    }
+
+    juce::String traceName = "grid_parameter_trace_" + signalType.toLowerCase() + ".csv";
+    traceFile = std::make_unique<std::ofstream>(outDir.getChildFile(traceName).getFullPathName().toStdString());
+    if (!traceFile->is_open()) {
+        std::cerr << "Failed to open " << traceName.toStdString() << " for writing" << std::endl;
+        traceFile.reset();
+    } else {
+        *traceFile << "runId,timeMs";
+        for (const auto& name : automatedNames)
+            *traceFile << "," << name.toStdString();
+        *traceFile << ",inputRmsDb,outputRmsDb,gainDb";
+        for (const auto& paramName : paramNames)
+            *traceFile << "," << paramName.toStdString();
+        *traceFile << ",inputGainDb\n";
+    }
+}
+
+ParameterChangeAnalyzer::~ParameterChangeAnalyzer() {}
+
+void ParameterChangeAnalyzer::prepare(double newSampleRate) {
+    sampleRate = newSampleRate;
+    schedule = std::make_unique<AutomationSchedule>(automation, sampleRate, rampStepSamples);
+    windowSamples = std::max(1, (int)std::lround(windowSeconds * sampleRate));
+
+    boundaries.clear();
+    for (const auto& event : schedule->getEvents()) {
+        if (boundaries.empty() || event.startSample != boundaries.back())
+            boundaries.push_back(event.startSample);
+    }
+}
+
+void ParameterChangeAnalyzer::writeParams(std::ofstream& out) const {
+    for (const auto& paramName : paramNames) {
+        float value = 0.0f;
+        auto it = current.paramValues.find(paramName);
+        if (it != current.paramValues.end())
+            value = it->second;
+        out << "," << value;
+    }
+    out << "," << current.inputGainDb << "\n";
+}
+
+void ParameterChangeAnalyzer::writeWindow(const Window& window, int64_t start, const std::vector<float>& values) {
+    if (!traceFile || window.inSq <= 0.0)
+        return;
+
+    const double inputRmsDb = 10.0 * std::log10(window.inSq / (double)windowSamples);
+    const double outputRmsDb = 10.0 * std::log10(std::max(window.outSq, 1e-30) / (double)windowSamples);
+
+    auto& out = *traceFile;
+    out << current.runId << "," << 1000.0 * (double)start / sampleRate;
+    for (float value : values)
+        out << "," << value;
+    out << "," << inputRmsDb << "," << outputRmsDb << "," << outputRmsDb - inputRmsDb;
+    writeParams(out);
+}
+
+void ParameterChangeAnalyzer::processInterval() {
+    auto& run = current;
+    if (run.interval < 0)
+        return;
+
+    // Steady state: the last quarter of the interval
+    const int numWindows = (int)run.windows.size();
+    const int steadyStart = numWindows - std::max(1, numWindows / 4);
+    double inSq = 0.0, outSq = 0.0;
+    for (int w = steadyStart; w < numWindows; ++w) {
+        inSq += run.windows[w].inSq;
+        outSq += run.windows[w].outSq;
+    }
+    const bool hasGain = numWindows > 0 && inSq > 0.0;
+    const double gainDb = hasGain ? 10.0 * std::log10(std::max(outSq, 1e-30) / inSq) : 0.0;
+
+    if (run.interval > 0 && hasGain) {
+        EventResult result;
+        result.gainBeforeDb = run.previousGainDb;
+        result.hasGainBefore = run.hasPreviousGain;
+        result.gainAfterDb = gainDb;
+        result.parameterChanges = run.parameterChanges;
+        result.changeSeconds = run.changeSeconds;
+        result.changeSamples = run.changeSamples;
+
+        // Settled after the last window outside the tolerance; overshoot past the new gain in the direction of
+        // the change
+        const double direction = gainDb >= run.previousGainDb ? 1.0 : -1.0;
+        const double windowMs = 1000.0 * (double)windowSamples / sampleRate;
+        for (int w = 0; w < numWindows; ++w) {
+            const auto& window = run.windows[w];
+            if (window.inSq <= 0.0)
+                continue;
+
+            const double windowGainDb = 10.0 * std::log10(std::max(window.outSq, 1e-30) / window.inSq);
+            if (std::abs(windowGainDb - gainDb) > settleToleranceDb)
+                result.settlingMs = (double)(w + 1) * windowMs;
+            result.overshootDb = std::max(result.overshootDb, direction * (windowGainDb - gainDb));
+        }
+
+        // One row per event starting at this interval
+        const auto& events = schedule->getEvents();
+        const int64_t start = intervalStart(run.interval);
+        for (int e = 0; e < (int)events.size(); ++e) {
+            if (events[e].startSample != start)
+                continue;
+            result.event = e;
+            result.fromValue = events[e].param < (int)run.valuesBefore.size() ? run.valuesBefore[events[e].param]
+                                                                              : 0.0f;
+            run.results.push_back(result);
+        }
+    }
+
+    if (hasGain) {
+        run.previousGainDb = gainDb;
+        run.hasPreviousGain = true;
+    }
+}
+
+void ParameterChangeAnalyzer::processRun() {
+    if (!eventsFile || current.runId < 0)
+        return;
+
+    // Baseline processing cost per sample from the blocks without parameter changes
+    const double baselinePerSample =
+        current.quietSamples > 0 ? current.quietSeconds / (double)current.quietSamples : 0.0;
+
+    const auto& events = schedule->getEvents();
+    const auto& automatedNames = schedule->getParameterNames();
+    auto& out = *eventsFile;
+    for (const auto& result : current.results) {
+        const auto& event = events[result.event];
+        out << current.runId << "," << result.event << "," << automatedNames[event.param].toStdString() << ","
+            << result.fromValue << "," << event.target << "," << 1000.0 * (double)event.startSample / sampleRate
+            << "," << 1000.0 * (double)(event.endSample - event.startSample) / sampleRate << ",";
+        if (result.hasGainBefore)
+            out << result.gainBeforeDb;
+        out << "," << result.gainAfterDb << ",";
+        if (result.hasGainBefore)
+            out << result.gainAfterDb - result.gainBeforeDb;
+        out << "," << result.settlingMs << "," << result.overshootDb << "," << result.parameterChanges << ",";
+        if (result.parameterChanges > 0) {
+            const double extraSeconds = result.changeSeconds - baselinePerSample * (double)result.changeSamples;
+            out << 1e6 * extraSeconds / (double)result.parameterChanges;
+        }
+        writeParams(out);
+    }
+}
+
+void ParameterChangeAnalyzer::processBlock(const BlockContext& ctx) {
+    if (automation.empty())
+        return;
+
+    // A new run id means the previous run is complete
+    if (ctx.runId != current.runId) {
+        processInterval();
+        processRun();
+
+        // Event positions and the window length are in samples; rebuild them for the new run's sample rate
+        if (ctx.sampleRate != sampleRate)
+            prepare(ctx.sampleRate);
+
+        current = RunIntervals();
+        current.runId = ctx.runId;
+        current.lastValues = ctx.automationValues;
+        current.paramValues = ctx.paramNamedValues;
+        current.inputGainDb = ctx.inputGainDb;
+    }
+
+    // The engine splits blocks at every event, so a block lies within one interval
+    const int interval = (int)(std::upper_bound(boundaries.begin(), boundaries.end(), ctx.firstSample) -
+                               boundaries.begin());
+    if (interval != current.interval) {
+        processInterval();
+        current.interval = interval;
+        current.windows.clear();
+        current.partial = {};
+        current.valuesBefore = current.lastValues;
+        current.parameterChanges = 0;
+        current.changeSeconds = 0.0;
+        current.changeSamples = 0;
+    }
+
+    if (ctx.parameterChanges > 0) {
+        current.parameterChanges += ctx.parameterChanges;
+        current.changeSeconds += ctx.processSeconds;
+        current.changeSamples += ctx.numSamples;
+    } else {
+        current.quietSeconds += ctx.processSeconds;
+        current.quietSamples += ctx.numSamples;
+    }
+
+    const int64_t start = intervalStart(interval);
+    int i = 0;
+    while (i < ctx.numSamples) {
+        const int64_t position = ctx.firstSample + i;
+        const int64_t offset = position - start;
+        if (offset % windowSamples == 0) {
+            current.partialStart = position;
+            current.partialValues = ctx.automationValues;
+        }
+
+        const int64_t toWindowEnd = windowSamples - offset % windowSamples;
+        const int count = (int)std::min<int64_t>(ctx.numSamples - i, toWindowEnd);
+
+        double inSq = 0.0, outSq = 0.0;
+        for (int j = i; j < i + count; ++j) {
+            inSq += (double)ctx.inL[j] * (double)ctx.inL[j];
+            outSq += (double)ctx.outL[j] * (double)ctx.outL[j];
+        }
+        current.partial.inSq += inSq;
+        current.partial.outSq += outSq;
+
+        if (count == toWindowEnd) {
+            current.windows.push_back(current.partial);
+            writeWindow(current.partial, current.partialStart, current.partialValues);
+            current.partial = {};
+        }
+        i += count;
+    }
+
+    current.lastValues = ctx.automationValues;
+}
+
+void ParameterChangeAnalyzer::finish(const juce::File& outDir) {
+    if (current.runId >= 0) {
+        processInterval();
+        processRun();
+        current = RunIntervals();
+    }
+
+    if (eventsFile) {
+        eventsFile->close();
+        eventsFile.reset();
+    }
+    if (traceFile) {
+        traceFile->close();
+        traceFile.reset();
+    }
+}
+
+std::unique_ptr<Analyzer> createParameterChangeAnalyzer(const juce::File& outDir,
+                                                        const std::vector<AutomationEventConfig>& automation,
+                                                        int rampStepSamples,
+                                                        const std::vector<juce::String>& paramNames,
+                                                        const juce::String& signalType) {
+    return std::make_unique<ParameterChangeAnalyzer>(outDir, automation, rampStepSamples, paramNames, signalType);
+}
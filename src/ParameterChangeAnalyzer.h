@@ -0,0 +1,99 @@
+#pragma once
+
+#include "Analyzer.h"
+#include "AutomationSchedule.h"
+#include "JuceHeader.h"
+#include <fstream>
+#include <map>
+#include <memory>
+#include <vector>
+
+// Response to in-run parameter automation. Input and output are reduced to 5 ms RMS windows that restart at
+// every event, giving a gain trace (grid_parameter_trace: one row per window with the automated values, so a
+// slow ramp across a run traces a dense 1-D curve) and, per event (grid_parameter_changes):
+//   - the steady gain before and after (last quarter of the surrounding intervals)
+//   - settling time: until the window gain stays within settleToleranceDb of the new steady gain
+//   - overshoot: the furthest the gain goes past its new value in the direction of the change
+//   - CPU per parameter change: processBlock time of the blocks that followed changes, less the run's
+//     per-sample baseline from change-free blocks
+// Use a stationary stimulus (sine, multitone) so the window gain only moves when the plugin does.
+struct ParameterChangeAnalyzer : public Analyzer {
+    static constexpr double windowSeconds = 0.005;
+    static constexpr double settleToleranceDb = 0.25;
+
+    ParameterChangeAnalyzer(const juce::File& outDir, const std::vector<AutomationEventConfig>& automation,
+                            int rampStepSamples, const std::vector<juce::String>& paramNames,
+                            const juce::String& signalType);
+    ~ParameterChangeAnalyzer() override;
+
+    void processBlock(const BlockContext& ctx) override;
+    void finish(const juce::File& outDir) override;
+
+private:
+    struct Window {
+        double inSq = 0.0;
+        double outSq = 0.0;
+    };
+
+    struct EventResult {
+        int event = 0;
+        float fromValue = 0.0f;
+        double gainBeforeDb = 0.0;
+        double gainAfterDb = 0.0;
+        bool hasGainBefore = false;
+        double settlingMs = 0.0;
+        double overshootDb = 0.0;
+        int parameterChanges = 0;
+        double changeSeconds = 0.0;
+        int64_t changeSamples = 0;
+    };
+
+    // Samples between consecutive event start times; interval k starts at boundaries[k - 1]
+    struct RunIntervals {
+        int runId = -1;
+        int interval = -1;
+        std::vector<Window> windows;
+        Window partial;
+        int64_t partialStart = 0;
+        std::vector<float> partialValues; // automated values when the partial window started
+        double previousGainDb = 0.0;
+        bool hasPreviousGain = false;
+        std::vector<float> valuesBefore; // automated values just before the current interval
+        std::vector<float> lastValues;
+        int parameterChanges = 0;
+        double changeSeconds = 0.0;
+        int64_t changeSamples = 0;
+        double quietSeconds = 0.0; // change-free blocks over the whole run
+        int64_t quietSamples = 0;
+        std::vector<EventResult> results;
+        std::map<juce::String, float> paramValues;
+        float inputGainDb = 0.0f;
+    };
+
+    RunIntervals current;
+    std::vector<AutomationEventConfig> automation;
+    int rampStepSamples;
+    std::vector<juce::String> paramNames;
+    juce::String signalType;
+
+    std::unique_ptr<AutomationSchedule> schedule;
+    std::vector<int64_t> boundaries; // distinct event start samples
+    double sampleRate = 0.0;
+    int windowSamples = 1;
+
+    std::unique_ptr<std::ofstream> eventsFile;
+    std::unique_ptr<std::ofstream> traceFile;
+
+    void prepare(double newSampleRate);
+    int64_t intervalStart(int interval) const { return interval > 0 ? boundaries[interval - 1] : 0; }
+    void writeParams(std::ofstream& out) const;
+    void writeWindow(const Window& window, int64_t start, const std::vector<float>& values);
+    void processInterval();
+    void processRun();
+};
+
+std::unique_ptr<Analyzer> createParameterChangeAnalyzer(const juce::File& outDir,
+                                                        const std::vector<AutomationEventConfig>& automation,
+                                                        int rampStepSamples,
+                                                        const std::vector<juce::String>& paramNames,
+                                                        const juce::String& signalType);
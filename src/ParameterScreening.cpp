@@ -0,0 +1,268 @@
+#include "ParameterScreening.h"
+#include "Analyzer.h"
+#include "BucketSpec.h"
+#include "MeasurementEngine.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <random>
+
+static const char* const metricNames[] = {"rmsDb", "peakDb", "crestDb", "zeroCrossingRate"};
+static constexpr int numMetrics = 4;
+
+// Summary metrics of outL per run, kept in memory for the screening
+struct ScreeningMetricsAnalyzer : public Analyzer {
+    struct RunMetrics {
+        double sumSq = 0.0;
+        float peak = 0.0f;
+        int64_t zeroCrossings = 0;
+        int64_t sampleCount = 0;
+        float lastSample = 0.0f;
+        double sampleRate = 48000.0;
+    };
+
+    std::map<int, RunMetrics> runs;
+
+    void processBlock(const BlockContext& ctx) override {
+        auto& run = runs[ctx.runId];
+        run.sampleRate = ctx.sampleRate;
+        for (int i = 0; i < ctx.numSamples; ++i) {
+            const float v = ctx.outL[i];
+            run.sumSq += (double)v * (double)v;
+            run.peak = std::max(run.peak, std::abs(v));
+            if (run.sampleCount + i > 0 && (v < 0.0f) != (run.lastSample < 0.0f))
+                run.zeroCrossings++;
+            run.lastSample = v;
+        }
+        run.sampleCount += ctx.numSamples;
+    }
+
+    void finish(const juce::File& outDir) override {}
+
+    double metric(int runId, int metricIndex) const {
+        auto it = runs.find(runId);
+        if (it == runs.end() || it->second.sampleCount == 0)
+            return 0.0;
+
+        const auto& run = it->second;
+        const double rmsDb = 10.0 * std::log10(std::max(run.sumSq / (double)run.sampleCount, 1e-20));
+        const double peakDb = 20.0 * std::log10(std::max((double)run.peak, 1e-10));
+        switch (metricIndex) {
+            case 0:
+                return rmsDb;
+            case 1:
+                return peakDb;
+            case 2:
+                return peakDb - rmsDb;
+            default:
+                return (double)run.zeroCrossings * run.sampleRate / (double)run.sampleCount;
+        }
+    }
+};
+
+Config runParameterScreening(juce::AudioPluginInstance& plugin, const Config& config, const juce::File& outDir) {
+    Config result = config;
+
+    // Factors: bucketed parameters with more than one value; the others stay at their single value
+    struct Factor {
+        int bucket = 0;
+        std::vector<float> values;
+    };
+    std::vector<Factor> factors;
+    std::vector<float> fixedValues;
+    for (int b = 0; b < (int)config.parameterBuckets.size(); ++b) {
+        const auto& bucketConfig = config.parameterBuckets[b];
+        BucketSpec spec;
+        spec.paramName = bucketConfig.paramName;
+        spec.strategy = BucketSpec::strategyFromString(bucketConfig.strategy);
+        spec.min = bucketConfig.min;
+        spec.max = bucketConfig.max;
+        spec.numBuckets = bucketConfig.numBuckets;
+        spec.values = bucketConfig.values;
+
+        auto values = spec.generateValues();
+        fixedValues.push_back(values.empty() ? 0.0f : values[values.size() / 2]);
+        if (values.size() > 1)
+            factors.push_back({b, values});
+    }
+    if (factors.empty()) {
+        std::cerr << "[screening] No parameter has more than one bucket value; nothing to screen" << std::endl;
+        return result;
+    }
+
+    std::vector<int> metrics;
+    for (const auto& name : config.screeningMetrics) {
+        int m = 0;
+        while (m < numMetrics && !name.equalsIgnoreCase(metricNames[m]))
+            ++m;
+        if (m < numMetrics)
+            metrics.push_back(m);
+        else
+            std::cerr << "Warning: Unknown screening metric: " << name << std::endl;
+    }
+    if (metrics.empty())
+        metrics = {0, 1};
+
+    // Trajectories: a random start on the bucket grid, then every factor moved once in random order
+    struct Step {
+        int factor = 0;
+        int before = 0; // run ids
+        int after = 0;
+        float delta = 0.0f;
+    };
+    std::vector<RunConfig> runs;
+    std::vector<Step> steps;
+    const float inputGainDb = config.inputGainBucketsDb.empty()
+                                  ? 0.0f
+                                  : *std::max_element(config.inputGainBucketsDb.begin(),
+                                                      config.inputGainBucketsDb.end());
+    std::mt19937_64 rng(deriveRunSeed((uint64_t)(uint32_t)config.seed, -1));
+
+    std::vector<int> levels(factors.size());
+    auto addRun = [&]() {
+        RunConfig run;
+        run.runId = (int)runs.size();
+        for (int b = 0; b < (int)config.parameterBuckets.size(); ++b)
+            run.paramValues[config.parameterBuckets[b].paramName] = fixedValues[b];
+        for (size_t f = 0; f < factors.size(); ++f)
+            run.paramValues[config.parameterBuckets[factors[f].bucket].paramName] = factors[f].values[levels[f]];
+        run.inputGainDb = inputGainDb;
+        runs.push_back(run);
+        return run.runId;
+    };
+
+    for (int t = 0; t < std::max(1, config.screeningTrajectories); ++t) {
+        for (size_t f = 0; f < factors.size(); ++f)
+            levels[f] = (int)(rng() % factors[f].values.size());
+
+        std::vector<int> order(factors.size());
+        for (size_t f = 0; f < order.size(); ++f)
+            order[f] = (int)f;
+        std::shuffle(order.begin(), order.end(), rng);
+
+        int previous = addRun();
+        for (int f : order) {
+            const int numLevels = (int)factors[f].values.size();
+            const int jump = std::max(1, numLevels / 2);
+            const float before = factors[f].values[levels[f]];
+            levels[f] = levels[f] + jump < numLevels ? levels[f] + jump : levels[f] - jump;
+            const int current = addRun();
+            steps.push_back({f, previous, current, factors[f].values[levels[f]] - before});
+            previous = current;
+        }
+    }
+
+    std::cerr << "[screening] " << factors.size() << " parameters, " << runs.size() << " screening runs" << std::endl;
+
+    // Only the measurement itself: no automation, linearity shortcut, host table or configured analyzers. Every
+    // run gets the same stimulus, so an elementary effect is the parameter's alone and not noise-to-noise spread.
+    Config screeningConfig = config;
+    screeningConfig.automation.clear();
+    screeningConfig.linearityCheck = false;
+    screeningConfig.seedPerRun = false;
+    screeningConfig.sampleRateBuckets.clear();
+    screeningConfig.blockSizeBuckets.clear();
+    screeningConfig.precision = "float";
+
+    auto metricsAnalyzer = std::make_unique<ScreeningMetricsAnalyzer>();
+    const auto* runMetrics = metricsAnalyzer.get();
+    std::vector<std::unique_ptr<Analyzer>> analyzers;
+    analyzers.push_back(std::move(metricsAnalyzer));
+    runMeasurementGrid(plugin, config.sampleRate, config.blockSize,
+                       (int64_t)(config.screeningSeconds * config.sampleRate), runs, analyzers, screeningConfig,
+                       outDir);
+
+    // mu* (mean |elementary effect|), mu and sigma per factor and metric
+    const int numFactors = (int)factors.size();
+    std::vector<double> muStar(numFactors * numMetrics, 0.0), mu(numFactors * numMetrics, 0.0);
+    std::vector<double> sigma(numFactors * numMetrics, 0.0);
+    std::vector<int> effectCount(numFactors, 0);
+    for (int m : metrics) {
+        for (int f = 0; f < numFactors; ++f) {
+            std::vector<double> effects;
+            for (const auto& step : steps) {
+                if (step.factor == f && step.delta != 0.0f)
+                    effects.push_back((runMetrics->metric(step.after, m) - runMetrics->metric(step.before, m)) /
+                                      (double)step.delta);
+            }
+            effectCount[f] = (int)effects.size();
+            if (effects.empty())
+                continue;
+
+            double sum = 0.0, sumAbs = 0.0;
+            for (double e : effects) {
+                sum += e;
+                sumAbs += std::abs(e);
+            }
+            const double mean = sum / (double)effects.size();
+            double variance = 0.0;
+            for (double e : effects)
+                variance += (e - mean) * (e - mean);
+            if (effects.size() > 1)
+                variance /= (double)(effects.size() - 1);
+
+            muStar[f * numMetrics + m] = sumAbs / (double)effects.size();
+            mu[f * numMetrics + m] = mean;
+            sigma[f * numMetrics + m] = std::sqrt(variance);
+        }
+    }
+
+    // Influence relative to the most influential factor, per metric; a factor is inert if it is below the
+    // threshold on every selected metric
+    std::vector<double> relative(numFactors * numMetrics, 0.0);
+    std::vector<double> influence(numFactors, 0.0);
+    for (int m : metrics) {
+        double maxMuStar = 0.0;
+        for (int f = 0; f < numFactors; ++f)
+            maxMuStar = std::max(maxMuStar, muStar[f * numMetrics + m]);
+        for (int f = 0; f < numFactors; ++f) {
+            relative[f * numMetrics + m] = maxMuStar > 0.0 ? muStar[f * numMetrics + m] / maxMuStar : 0.0;
+            influence[f] = std::max(influence[f], relative[f * numMetrics + m]);
+        }
+    }
+
+    int64_t gridBefore = 1, gridAfter = 1;
+    std::vector<bool> collapsed(numFactors, false);
+    for (int f = 0; f < numFactors; ++f) {
+        const auto& bucketConfig = config.parameterBuckets[factors[f].bucket];
+        const bool inert = influence[f] < config.screeningThreshold;
+        collapsed[f] = inert && config.screeningCollapse;
+        gridBefore *= (int64_t)factors[f].values.size();
+        gridAfter *= collapsed[f] ? 1 : (int64_t)factors[f].values.size();
+
+        std::cerr << "[screening] " << bucketConfig.paramName << ": relative influence " << influence[f]
+                  << (inert ? " (inert" : " (kept") << (collapsed[f] ? ", collapsed)" : ")") << std::endl;
+
+        if (collapsed[f]) {
+            auto& bucket = result.parameterBuckets[factors[f].bucket];
+            bucket.strategy = "ExplicitValues";
+            bucket.values = {fixedValues[factors[f].bucket]};
+        }
+    }
+    if (config.screeningCollapse)
+        std::cerr << "[screening] Parameter combinations: " << gridBefore << " -> " << gridAfter << std::endl;
+
+    juce::String filename = "grid_screening_" + config.signalType.toLowerCase() + ".csv";
+    std::ofstream csvFile(outDir.getChildFile(filename).getFullPathName().toStdString());
+    if (!csvFile.is_open()) {
+        std::cerr << "Failed to open " << filename.toStdString() << " for writing" << std::endl;
+        return result;
+    }
+
+    csvFile << "paramName,metric,muStar,mu,sigma,relativeInfluence,numEffects,inert,collapsedTo\n";
+    for (int f = 0; f < numFactors; ++f) {
+        for (int m : metrics) {
+            const int index = f * numMetrics + m;
+            csvFile << config.parameterBuckets[factors[f].bucket].paramName.toStdString() << "," << metricNames[m]
+                    << "," << muStar[index] << "," << mu[index] << "," << sigma[index] << "," << relative[index]
+                    << "," << effectCount[f] << "," << (influence[f] < config.screeningThreshold ? 1 : 0) << ",";
+            if (collapsed[f])
+                csvFile << fixedValues[factors[f].bucket];
+            csvFile << "\n";
+        }
+    }
+
+    return result;
+}
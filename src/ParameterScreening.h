@@ -0,0 +1,14 @@
+#pragma once
+
+#include "Config.h"
+#include "JuceHeader.h"
+
+// Morris elementary-effects screening over config.parameterBuckets. screeningTrajectories random one-at-a-time
+// trajectories through the bucket grid (each bucketed parameter moved once per trajectory, by about half its
+// range) are measured at the highest input gain bucket for screeningSeconds each, and summary metrics of the
+// output are computed per run. Per parameter and metric, mu* (mean |effect|) and sigma (spread of the effect,
+// i.e. interaction/nonlinearity) are written to grid_screening_<signal>.csv, with mu* relative to the most
+// influential parameter. Parameters whose relative influence on every metric is below screeningThreshold are
+// inert; with screeningCollapse they are fixed at their middle bucket value in the returned config.
+// Metrics: "rmsDb", "peakDb", "crestDb", "zeroCrossingRate" (default rmsDb and peakDb).
+Config runParameterScreening(juce::AudioPluginInstance& plugin, const Config& config, const juce::File& outDir);
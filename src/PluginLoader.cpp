@@ -1,8 +1,86 @@
 #include "PluginLoader.h"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <limits>
+
+// Tries the requested layout with canonical, then discrete, channel sets for each main bus, and a sidechain as
+// wide as the main input, then mono, then stereo. Layouts that leave the auxiliary buses as they were come last.
+// The first layout the plugin supports is applied.
+static void negotiateBusLayout(juce::AudioPluginInstance& instance, const BusLayoutRequest& request) {
+    const auto defaultLayout = instance.getBusesLayout();
+
+    auto mainSets = [](int requested, const juce::AudioChannelSet& current) {
+        if (requested <= 0)
+            return std::vector<juce::AudioChannelSet>{current};
+        return std::vector<juce::AudioChannelSet>{juce::AudioChannelSet::canonicalChannelSet(requested),
+                                                  juce::AudioChannelSet::discreteChannels(requested)};
+    };
+    const auto inputSets = mainSets(request.inputChannels, defaultLayout.getMainInputChannelSet());
+    const auto outputSets = mainSets(request.outputChannels, defaultLayout.getMainOutputChannelSet());
+    const bool hasSidechainBus = defaultLayout.inputBuses.size() > 1;
+    if (request.sidechain && !hasSidechainBus)
+        std::cerr << "Warning: Plugin has no sidechain input bus" << std::endl;
+
+    std::vector<juce::AudioProcessor::BusesLayout> candidates;
+    for (bool keepAuxiliary : {false, true}) {
+        for (const auto& inputSet : inputSets) {
+            for (const auto& outputSet : outputSets) {
+                std::vector<juce::AudioChannelSet> sidechainSets{juce::AudioChannelSet::disabled()};
+                if (request.sidechain && hasSidechainBus && !keepAuxiliary)
+                    sidechainSets = {inputSet, juce::AudioChannelSet::mono(), juce::AudioChannelSet::stereo()};
+
+                for (const auto& sidechainSet : sidechainSets) {
+                    auto layout = defaultLayout;
+                    if (layout.inputBuses.size() > 0)
+                        layout.inputBuses.set(0, inputSet);
+                    if (layout.outputBuses.size() > 0)
+                        layout.outputBuses.set(0, outputSet);
+                    if (!keepAuxiliary) {
+                        for (int bus = 1; bus < layout.inputBuses.size(); ++bus)
+                            layout.inputBuses.set(bus, bus == 1 ? sidechainSet : juce::AudioChannelSet::disabled());
+                        for (int bus = 1; bus < layout.outputBuses.size(); ++bus)
+                            layout.outputBuses.set(bus, juce::AudioChannelSet::disabled());
+                    }
+                    candidates.push_back(layout);
+                }
+            }
+        }
+    }
+
+    for (const auto& layout : candidates) {
+        if (instance.checkBusesLayoutSupported(layout) && instance.setBusesLayout(layout))
+            break;
+    }
+
+    const int mainInputs = instance.getMainBusNumInputChannels();
+    const int mainOutputs = instance.getMainBusNumOutputChannels();
+    const int sidechainInputs = instance.getTotalNumInputChannels() - mainInputs;
+    if ((request.inputChannels > 0 && mainInputs != request.inputChannels) ||
+        (request.outputChannels > 0 && mainOutputs != request.outputChannels))
+        std::cerr << "Warning: Plugin does not support the requested channel counts" << std::endl;
+    if (request.sidechain && hasSidechainBus && sidechainInputs == 0)
+        std::cerr << "Warning: Plugin does not allow its sidechain bus to be enabled" << std::endl;
+    std::cerr << "Bus layout: " << mainInputs << " in, " << mainOutputs << " out, " << sidechainInputs
+              << " sidechain" << std::endl;
+}
+
+std::vector<juce::String> getChannelNames(const juce::AudioChannelSet& layout, int numChannels) {
+    std::vector<juce::String> names;
+    for (int ch = 0; ch < numChannels; ++ch) {
+        juce::String name;
+        if (ch < 2)
+            name = ch == 0 ? "L" : "R";
+        else if (ch < layout.size())
+            name = juce::AudioChannelSet::getAbbreviatedChannelTypeName(layout.getTypeOfChannel(ch));
+        names.push_back(name.isNotEmpty() ? name : juce::String(ch + 1));
+    }
+    return names;
+}
 
 std::unique_ptr<juce::AudioPluginInstance> loadPluginInstance(const juce::File& pluginFile, double sampleRate,
-                                                              int blockSize, juce::String& errorMessageOut) {
+                                                              int blockSize, juce::String& errorMessageOut,
+                                                              const BusLayoutRequest& busLayout) {
     errorMessageOut.clear();
 
     // VST3 plugins on macOS are bundles (directories), not files
@@ -92,19 +170,46 @@ std::unique_ptr<juce::AudioPluginInstance> loadPluginInstance(const juce::File&
         return nullptr;
     }
 
+    negotiateBusLayout(*instance, busLayout);
     instance->prepareToPlay(sampleRate, blockSize);
 
     return instance;
 }
 
-std::map<juce::String, juce::AudioProcessorParameter*> buildParameterMap(juce::AudioPluginInstance& plugin,
-                                                                         bool uiOnly) {
-    std::map<juce::String, juce::AudioProcessorParameter*> paramMap;
+struct ParameterEntry {
+    juce::AudioProcessorParameter* param = nullptr;
+    juce::String name; // as reported
+    juce::String key;  // trimmed, lower-case and disambiguated
+};
+
+static std::vector<ParameterEntry> listParameters(juce::AudioPluginInstance& plugin) {
+    std::vector<ParameterEntry> entries;
+    std::map<juce::String, int> nameCounts;
 
     for (auto* param : plugin.getParameters()) {
         if (param == nullptr)
             continue;
 
+        ParameterEntry entry;
+        entry.param = param;
+        entry.name = param->getName(512);
+        entry.key = entry.name.trim().toLowerCase();
+        const int count = ++nameCounts[entry.key];
+        if (count > 1)
+            entry.key += " #" + juce::String(count);
+        entries.push_back(entry);
+    }
+
+    return entries;
+}
+
+std::map<juce::String, juce::AudioProcessorParameter*> buildParameterMap(juce::AudioPluginInstance& plugin,
+                                                                         bool uiOnly) {
+    std::map<juce::String, juce::AudioProcessorParameter*> paramMap;
+
+    for (const auto& entry : listParameters(plugin)) {
+        auto* param = entry.param;
+
         // Filter out non-UI parameters if requested
         if (uiOnly) {
             // Skip meta parameters (internal automation)
@@ -116,29 +221,83 @@ std::map<juce::String, juce::AudioProcessorParameter*> buildParameterMap(juce::A
                 continue;
 
             // Skip MIDI CC parameters (they're not UI-exposed)
-            juce::String paramName = param->getName(512);
-            if (paramName.containsIgnoreCase("MIDI CC") || paramName.containsIgnoreCase("midi cc"))
+            if (entry.name.containsIgnoreCase("MIDI CC"))
                 continue;
         }
 
-        juce::String paramName = param->getName(512);
-        paramName = paramName.trim().toLowerCase();
-        paramMap[paramName] = param;
+        paramMap[entry.key] = param;
     }
 
     return paramMap;
 }
 
-void setParameterValue(juce::AudioPluginInstance& plugin,
-                       const std::map<juce::String, juce::AudioProcessorParameter*>& paramMap,
-                       const juce::String& paramName, float normalizedValue) {
-    juce::String searchName = paramName.trim().toLowerCase();
-    auto it = paramMap.find(searchName);
+ParameterIndex::ParameterIndex(juce::AudioPluginInstance& plugin) {
+    const auto entries = listParameters(plugin);
+    parameters.reserve(entries.size());
+    indexByKey.reserve(entries.size() * 2);
 
-    if (it == paramMap.end()) {
-        std::cerr << "Warning: Parameter not found: " << paramName << std::endl;
-        return;
+    for (const auto& entry : entries) {
+        const int index = (int)parameters.size();
+        parameters.push_back(entry.param);
+        indexByKey[entry.key] = index;
+        if (entry.key.endsWith(" #2"))
+            std::cerr << "Warning: Several parameters are named \"" << entry.name.trim()
+                      << "\"; the repeats are addressed as \"" << entry.key << "\", \"... #3\" and so on"
+                      << std::endl;
+    }
+
+    // Host parameter IDs as a second key; a name always takes precedence over an equal ID
+    for (int index = 0; index < (int)parameters.size(); ++index) {
+        if (auto* hosted = dynamic_cast<juce::HostedAudioProcessorParameter*>(parameters[index])) {
+            const juce::String id = hosted->getParameterID().trim().toLowerCase();
+            if (id.isNotEmpty())
+                indexByKey.insert({id, index});
+        }
     }
+}
+
+int ParameterIndex::indexOf(const juce::String& nameOrId) const {
+    auto it = indexByKey.find(nameOrId.trim().toLowerCase());
+    return it != indexByKey.end() ? it->second : -1;
+}
+
+juce::AudioProcessorParameter* ParameterIndex::find(const juce::String& nameOrId) const {
+    const int index = indexOf(nameOrId);
+    return index >= 0 ? parameters[index] : nullptr;
+}
+
+ParameterSetter::ParameterSetter(const ParameterIndex& index, const std::vector<juce::String>& paramNames) {
+    for (const auto& name : paramNames) {
+        auto* param = index.find(name);
+        if (param == nullptr)
+            std::cerr << "Warning: Parameter not found: " << name << std::endl;
+        parameters.push_back(param);
+    }
+    invalidate();
+}
+
+int ParameterSetter::apply(const std::vector<float>& values) {
+    int numSet = 0;
+    for (size_t p = 0; p < parameters.size() && p < values.size(); ++p) {
+        if (parameters[p] == nullptr || std::isnan(values[p]) || values[p] == applied[p])
+            continue;
+
+        parameters[p]->setValueNotifyingHost(values[p]);
+        applied[p] = values[p];
+        numSet++;
+    }
+    return numSet;
+}
+
+void ParameterSetter::invalidate() {
+    applied.assign(parameters.size(), std::numeric_limits<float>::quiet_NaN());
+}
+
+float snapToParameterStep(const juce::AudioProcessorParameter& param, float normalizedValue) {
+    const int numSteps = param.getNumSteps();
+    if (numSteps < 2 || numSteps >= juce::AudioProcessor::getDefaultNumParameterSteps())
+        return normalizedValue;
 
-    it->second->setValueNotifyingHost(normalizedValue);
+    const float maxStep = (float)(numSteps - 1);
+    return std::round(std::clamp(normalizedValue, 0.0f, 1.0f) * maxStep) / maxStep;
 }
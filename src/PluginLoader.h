@@ -3,13 +3,66 @@
 #include "JuceHeader.h"
 #include <map>
 #include <memory>
+#include <unordered_map>
+#include <vector>
+
+// Bus layout to negotiate before the plugin is prepared. Channel counts of 0 keep the plugin's default for that
+// main bus. The sidechain is the plugin's second input bus; further auxiliary buses are disabled where the plugin
+// allows it, so no work goes to channels nobody reads.
+struct BusLayoutRequest {
+    int inputChannels = 0;
+    int outputChannels = 0;
+    bool sidechain = false;
+};
 
 std::unique_ptr<juce::AudioPluginInstance> loadPluginInstance(const juce::File& pluginFile, double sampleRate,
-                                                              int blockSize, juce::String& errorMessageOut);
+                                                              int blockSize, juce::String& errorMessageOut,
+                                                              const BusLayoutRequest& busLayout = {});
+
+// Column names for numChannels channels of a bus: "L" and "R" for the first two, then the layout's abbreviation
+// ("C", "Lfe", "Ls"...) or, past the layout or failing that, the channel number
+std::vector<juce::String> getChannelNames(const juce::AudioChannelSet& layout, int numChannels);
 
+// Keys are trimmed lower-case names; a name shared by several parameters gets " #2", " #3"... appended on its
+// repeats, in parameter order, so no parameter is hidden behind another
 std::map<juce::String, juce::AudioProcessorParameter*> buildParameterMap(juce::AudioPluginInstance& plugin,
                                                                          bool uiOnly = false);
 
-void setParameterValue(juce::AudioPluginInstance& plugin,
-                       const std::map<juce::String, juce::AudioProcessorParameter*>& paramMap,
-                       const juce::String& paramName, float normalizedValue);
+// Every parameter of a plugin, resolved once: the buildParameterMap() keys and, where the host exposes one, the
+// parameter ID, hashed to a stable index into the plugin's non-null parameters
+class ParameterIndex {
+public:
+    explicit ParameterIndex(juce::AudioPluginInstance& plugin);
+
+    int indexOf(const juce::String& nameOrId) const; // -1 if unknown
+    juce::AudioProcessorParameter* find(const juce::String& nameOrId) const;
+    juce::AudioProcessorParameter* get(int index) const { return parameters[index]; }
+    int size() const { return (int)parameters.size(); }
+
+private:
+    struct StringHash {
+        size_t operator()(const juce::String& s) const { return (size_t)s.hashCode64(); }
+    };
+
+    std::vector<juce::AudioProcessorParameter*> parameters;
+    std::unordered_map<juce::String, int, StringHash> indexByKey;
+};
+
+// Applies values for a fixed list of parameters, resolved once, in the order of the list. Only values that
+// differ from the last ones applied reach the plugin, so consecutive grid runs cost one call per changed
+// parameter. NaN leaves a parameter as it is.
+class ParameterSetter {
+public:
+    ParameterSetter(const ParameterIndex& index, const std::vector<juce::String>& paramNames);
+
+    int apply(const std::vector<float>& values); // returns the number of parameters set
+    void invalidate();                           // next apply() sets everything, e.g. after an external change
+
+private:
+    std::vector<juce::AudioProcessorParameter*> parameters; // nullptr where the name did not resolve
+    std::vector<float> applied;                             // NaN until set
+};
+
+// Nearest value a discrete parameter (switch, choice) can take: getNumSteps() evenly spaced normalised values.
+// Continuous parameters are returned unchanged.
+float snapToParameterStep(const juce::AudioProcessorParameter& param, float normalizedValue);
@@ -0,0 +1,114 @@
+#include "QuantileSketch.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+QuantileSketch::QuantileSketch(int k) : k(std::max(8, k)) {
+    clear();
+}
+
+void QuantileSketch::clear() {
+    levels.assign(1, {});
+    levels[0].reserve(k);
+    updateCapacities();
+    totalCount = 0;
+    size = 0;
+    minSeen = 0.0f;
+    maxSeen = 0.0f;
+    coinState = 0x2545F491u;
+}
+
+void QuantileSketch::updateCapacities() {
+    const int numLevels = (int)levels.size();
+    capacities.resize(numLevels);
+    totalCapacity = 0;
+    for (int h = 0; h < numLevels; ++h) {
+        const int depth = numLevels - 1 - h;
+        capacities[h] = std::max(2, (int)std::ceil((double)k * std::pow(2.0 / 3.0, (double)depth)));
+        totalCapacity += capacities[h];
+    }
+}
+
+void QuantileSketch::add(float value) {
+    if (totalCount == 0) {
+        minSeen = value;
+        maxSeen = value;
+    } else {
+        minSeen = std::min(minSeen, value);
+        maxSeen = std::max(maxSeen, value);
+    }
+
+    levels[0].push_back(value);
+    ++size;
+    ++totalCount;
+
+    if (size >= totalCapacity)
+        compress();
+}
+
+void QuantileSketch::compress() {
+    for (int h = 0; h < (int)levels.size(); ++h) {
+        if ((int)levels[h].size() < capacities[h])
+            continue;
+
+        if (h + 1 == (int)levels.size()) {
+            levels.emplace_back();
+            updateCapacities();
+        }
+
+        // An odd item out stays behind so weights are conserved exactly
+        auto& level = levels[h];
+        float leftover = 0.0f;
+        const bool hasLeftover = (level.size() % 2) != 0;
+        if (hasLeftover) {
+            leftover = level.back();
+            level.pop_back();
+        }
+
+        std::sort(level.begin(), level.end());
+
+        coinState ^= coinState << 13;
+        coinState ^= coinState >> 17;
+        coinState ^= coinState << 5;
+        const size_t offset = coinState & 1u;
+
+        auto& next = levels[h + 1];
+        for (size_t i = offset; i < level.size(); i += 2)
+            next.push_back(level[i]);
+
+        size -= (int)level.size() / 2;
+        level.clear();
+        if (hasLeftover)
+            level.push_back(leftover);
+
+        // One compaction per overflow keeps the amortised cost low
+        break;
+    }
+}
+
+float QuantileSketch::quantile(double q) const {
+    if (totalCount == 0)
+        return 0.0f;
+    if (q <= 0.0)
+        return minSeen;
+    if (q >= 1.0)
+        return maxSeen;
+
+    std::vector<std::pair<float, int64_t>> weighted;
+    weighted.reserve(size);
+    for (int h = 0; h < (int)levels.size(); ++h) {
+        for (float value : levels[h])
+            weighted.push_back({value, (int64_t)1 << h});
+    }
+    std::sort(weighted.begin(), weighted.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    const double target = q * (double)totalCount;
+    int64_t cumulative = 0;
+    for (const auto& [value, weight] : weighted) {
+        cumulative += weight;
+        if ((double)cumulative >= target)
+            return value;
+    }
+    return maxSeen;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// KLL streaming quantile sketch (Karnin, Lang & Liberty, 2016).
+// Values enter level 0; when the sketch is over capacity the lowest full level is sorted and every other
+// item is promoted one level up with doubled weight. Level capacities shrink geometrically (by 2/3) below
+// the top level, so memory stays at roughly 3k items however many values are added, and rank error is
+// about 1.7 / k of the count. The promotion coin comes from a fixed-seed generator, so the same input
+// always yields the same sketch.
+struct QuantileSketch {
+    explicit QuantileSketch(int k = 200);
+
+    void add(float value);
+    void clear();
+
+    int64_t count() const { return totalCount; }
+    float minValue() const { return minSeen; }
+    float maxValue() const { return maxSeen; }
+
+    // Value at normalised rank q in [0, 1]; 0 when the sketch is empty
+    float quantile(double q) const;
+
+private:
+    int k;
+    std::vector<std::vector<float>> levels;
+    std::vector<int> capacities; // per level, recomputed when a level is added
+    int totalCapacity = 0;
+    int64_t totalCount = 0;
+    int size = 0; // items held across all levels
+    float minSeen = 0.0f;
+    float maxSeen = 0.0f;
+    uint32_t coinState = 0x2545F491u;
+
+    void updateCapacities();
+    void compress();
+};
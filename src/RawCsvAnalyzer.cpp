@@ -20,13 +20,15 @@ void RawCsvAnalyzer::processBlock(const BlockContext& ctx) {
     if (!csvFile)
         return;
 
+    // Every channel of the main input bus, the sidechain and the main output bus
+    const ChannelView<float>* buses[] = {&ctx.inputs, &ctx.sidechain, &ctx.outputs};
     if (!headerWritten) {
-        *csvFile << "runId,sample,time_sec,inL";
-        if (ctx.inR != nullptr)
-            *csvFile << ",inR";
-        *csvFile << ",outL";
-        if (ctx.outR != nullptr)
-            *csvFile << ",outR";
+        static const char* const prefixes[] = {"in", "sc", "out"};
+        *csvFile << "runId,sample,time_sec";
+        for (int b = 0; b < 3; ++b) {
+            for (int ch = 0; ch < buses[b]->numChannels; ++ch)
+                *csvFile << "," << prefixes[b] << buses[b]->names[ch].toStdString();
+        }
         *csvFile << "\n";
         headerWritten = true;
     }
@@ -35,12 +37,11 @@ void RawCsvAnalyzer::processBlock(const BlockContext& ctx) {
         int64_t sampleIndex = ctx.firstSample + i;
         double timeSec = (double)sampleIndex / ctx.sampleRate;
 
-        *csvFile << ctx.runId << "," << sampleIndex << "," << timeSec << "," << ctx.inL[i];
-        if (ctx.inR != nullptr)
-            *csvFile << "," << ctx.inR[i];
-        *csvFile << "," << ctx.outL[i];
-        if (ctx.outR != nullptr)
-            *csvFile << "," << ctx.outR[i];
+        *csvFile << ctx.runId << "," << sampleIndex << "," << timeSec;
+        for (const auto* bus : buses) {
+            for (int ch = 0; ch < bus->numChannels; ++ch)
+                *csvFile << "," << (*bus)[ch][i];
+        }
         *csvFile << "\n";
     }
 }
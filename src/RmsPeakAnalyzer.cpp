@@ -1,4 +1,5 @@
 #include "RmsPeakAnalyzer.h"
+#include <algorithm>
 #include <cmath>
 #include <fstream>
 #include <iostream>
@@ -9,42 +10,122 @@ RmsPeakAnalyzer::RmsPeakAnalyzer(const juce::File& outDir, const std::vector<juc
 
 RmsPeakAnalyzer::~RmsPeakAnalyzer() {}
 
-void RmsPeakAnalyzer::processBlock(const BlockContext& ctx) {
-    auto& stats = perRunStats[ctx.runId];
+void CompensatedSum::add(double value) {
+    const double t = sum + value;
+    if (std::abs(sum) >= std::abs(value))
+        compensation += (sum - t) + value;
+    else
+        compensation += (value - t) + sum;
+    sum = t;
+}
+
+// One pass over a channel's block: sum, sum of squares, peak and zero crossings. The work is split across
+// independent lanes with no branches in the loop so the compiler can keep each lane in a vector register;
+// the lane partials are then combined pairwise and added to the run totals with compensation.
+template <typename SampleType>
+static void accumulateChannel(ChannelStats& stats, const SampleType* x, int numSamples, bool continuesRun) {
+    if (numSamples <= 0)
+        return;
+
+    constexpr int lanes = 8;
+    double sum[lanes] = {};
+    double sumSq[lanes] = {};
+    SampleType peak[lanes] = {};
+    int crossings[lanes] = {};
+
+    // Sample 0 is compared against the last sample of the previous block
+    sum[0] = (double)x[0];
+    sumSq[0] = (double)x[0] * (double)x[0];
+    peak[0] = std::abs(x[0]);
+    if (continuesRun)
+        crossings[0] = (int)((stats.lastSample < 0.0) != (x[0] < 0));
+
+    int i = 1;
+    for (; i + lanes <= numSamples; i += lanes) {
+        for (int l = 0; l < lanes; ++l) {
+            const SampleType v = x[i + l];
+            const double d = (double)v;
+            sum[l] += d;
+            sumSq[l] += d * d;
+            peak[l] = std::max(peak[l], std::abs(v));
+            crossings[l] += (int)((x[i + l - 1] < 0) != (v < 0));
+        }
+    }
+    for (int l = 0; i < numSamples; ++i, ++l) {
+        const SampleType v = x[i];
+        const double d = (double)v;
+        sum[l] += d;
+        sumSq[l] += d * d;
+        peak[l] = std::max(peak[l], std::abs(v));
+        crossings[l] += (int)((x[i - 1] < 0) != (v < 0));
+    }
+
+    for (int width = lanes / 2; width > 0; width /= 2) {
+        for (int l = 0; l < width; ++l) {
+            sum[l] += sum[l + width];
+            sumSq[l] += sumSq[l + width];
+            peak[l] = std::max(peak[l], peak[l + width]);
+            crossings[l] += crossings[l + width];
+        }
+    }
+
+    stats.sum.add(sum[0]);
+    stats.sumSq.add(sumSq[0]);
+    stats.peak = std::max(stats.peak, (double)peak[0]);
+    stats.zeroCrossings += crossings[0];
+    stats.lastSample = x[numSamples - 1];
+}
+
+// Runs the accumulation over every channel of a bus, growing the run's statistics to the bus width
+template <typename SampleType>
+static void accumulateBus(std::vector<ChannelStats>& stats, const ChannelView<SampleType>& bus, int start,
+                          int numSamples, bool continuesRun) {
+    if ((int)stats.size() < bus.numChannels)
+        stats.resize(bus.numChannels);
+    for (int ch = 0; ch < bus.numChannels; ++ch)
+        accumulateChannel(stats[ch], bus[ch] + start, numSamples, continuesRun);
+}
+
+static void noteChannelNames(std::vector<juce::String>& names, const ChannelView<float>& bus) {
+    if (bus.numChannels > (int)names.size())
+        names.assign(bus.names, bus.names + bus.numChannels);
+}
+
+void RmsPeakAnalyzer::beginBlock(const BlockContext& ctx) {
+    currentStats = &perRunStats[ctx.runId];
+    noteChannelNames(inputNames, ctx.inputs);
+    noteChannelNames(outputNames, ctx.outputs);
 
     // Store metadata on first block of each run
     if (runParamValues.find(ctx.runId) == runParamValues.end()) {
         runParamValues[ctx.runId] = ctx.paramNamedValues;
         runInputGainDb[ctx.runId] = ctx.inputGainDb;
     }
+}
 
-    for (int i = 0; i < ctx.numSamples; ++i) {
-        // Input L
-        float inL = ctx.inL[i];
-        stats.sumSqInL += (double)(inL * inL);
-        stats.peakInL = std::max(stats.peakInL, std::abs(inL));
-
-        // Input R
-        if (ctx.inR != nullptr) {
-            float inR = ctx.inR[i];
-            stats.sumSqInR += (double)(inR * inR);
-            stats.peakInR = std::max(stats.peakInR, std::abs(inR));
-        }
-
-        // Output L
-        float outL = ctx.outL[i];
-        stats.sumSqOutL += (double)(outL * outL);
-        stats.peakOutL = std::max(stats.peakOutL, std::abs(outL));
+void RmsPeakAnalyzer::processSamples(const BlockContext& ctx, int start, int numSamples) {
+    auto& stats = *currentStats;
+    const bool continuesRun = stats.sampleCount > 0 || start > 0;
+
+    // Double-precision runs are measured before rounding to float, so the statistics of quiet outputs are not
+    // limited by float resolution
+    if (!ctx.outputsDouble.empty()) {
+        accumulateBus(stats.inputs, ctx.inputsDouble, start, numSamples, continuesRun);
+        accumulateBus(stats.outputs, ctx.outputsDouble, start, numSamples, continuesRun);
+    } else {
+        accumulateBus(stats.inputs, ctx.inputs, start, numSamples, continuesRun);
+        accumulateBus(stats.outputs, ctx.outputs, start, numSamples, continuesRun);
+    }
+}
 
-        // Output R
-        if (ctx.outR != nullptr) {
-            float outR = ctx.outR[i];
-            stats.sumSqOutR += (double)(outR * outR);
-            stats.peakOutR = std::max(stats.peakOutR, std::abs(outR));
-        }
+void RmsPeakAnalyzer::endBlock(const BlockContext& ctx) {
+    currentStats->sampleCount += ctx.numSamples;
+}
 
-        stats.sampleCount++;
-    }
+void RmsPeakAnalyzer::processBlock(const BlockContext& ctx) {
+    beginBlock(ctx);
+    processSamples(ctx, 0, ctx.numSamples);
+    endBlock(ctx);
 }
 
 void RmsPeakAnalyzer::finish(const juce::File& outDir) {
@@ -63,8 +144,12 @@ void RmsPeakAnalyzer::finish(const juce::File& outDir) {
         out << "," << paramName.toStdString();
     }
     out << ",inputGainDb";
-    out << ",rmsInL,rmsInR,rmsOutL,rmsOutR";
-    out << ",peakInL,peakInR,peakOutL,peakOutR";
+    for (const char* metric : {"rms", "peak", "dc", "crest", "zeroCrossings"}) {
+        for (const auto& name : inputNames)
+            out << "," << metric << "In" << name.toStdString();
+        for (const auto& name : outputNames)
+            out << "," << metric << "Out" << name.toStdString();
+    }
     out << "\n";
 
     // Data rows
@@ -90,13 +175,35 @@ void RmsPeakAnalyzer::finish(const juce::File& outDir) {
             inputGain = gainIt->second;
         out << "," << inputGain;
 
-        double rmsInL = stats.sampleCount > 0 ? std::sqrt(stats.sumSqInL / stats.sampleCount) : 0.0;
-        double rmsInR = stats.sampleCount > 0 ? std::sqrt(stats.sumSqInR / stats.sampleCount) : 0.0;
-        double rmsOutL = stats.sampleCount > 0 ? std::sqrt(stats.sumSqOutL / stats.sampleCount) : 0.0;
-        double rmsOutR = stats.sampleCount > 0 ? std::sqrt(stats.sumSqOutR / stats.sampleCount) : 0.0;
+        // Columns for every channel of the widest buses; channels this run did not have (a mono bus's right
+        // channel) are written as zero
+        static const ChannelStats missing;
+        std::vector<const ChannelStats*> channels;
+        for (size_t ch = 0; ch < inputNames.size(); ++ch)
+            channels.push_back(ch < stats.inputs.size() ? &stats.inputs[ch] : &missing);
+        for (size_t ch = 0; ch < outputNames.size(); ++ch)
+            channels.push_back(ch < stats.outputs.size() ? &stats.outputs[ch] : &missing);
+
+        std::vector<double> rms(channels.size(), 0.0), dc(channels.size(), 0.0), crest(channels.size(), 0.0);
+        for (size_t ch = 0; ch < channels.size(); ++ch) {
+            const auto& channel = *channels[ch];
+            if (stats.sampleCount > 0) {
+                rms[ch] = std::sqrt(std::max(channel.sumSq.value(), 0.0) / stats.sampleCount);
+                dc[ch] = channel.sum.value() / stats.sampleCount;
+            }
+            crest[ch] = rms[ch] > 0.0 ? channel.peak / rms[ch] : 0.0;
+        }
 
-        out << "," << rmsInL << "," << rmsInR << "," << rmsOutL << "," << rmsOutR;
-        out << "," << stats.peakInL << "," << stats.peakInR << "," << stats.peakOutL << "," << stats.peakOutR;
+        for (double value : rms)
+            out << "," << value;
+        for (const auto* channel : channels)
+            out << "," << channel->peak;
+        for (double value : dc)
+            out << "," << value;
+        for (double value : crest)
+            out << "," << value;
+        for (const auto* channel : channels)
+            out << "," << channel->zeroCrossings;
         out << "\n";
     }
 }
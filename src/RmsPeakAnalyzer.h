@@ -5,15 +5,27 @@
 #include <map>
 #include <vector>
 
+// Neumaier-compensated running sum, so long runs do not lose the small per-block contributions
+struct CompensatedSum {
+    double sum = 0.0;
+    double compensation = 0.0;
+
+    void add(double value);
+    double value() const { return sum + compensation; }
+};
+
+struct ChannelStats {
+    CompensatedSum sum;   // for the DC offset
+    CompensatedSum sumSq; // for the RMS
+    double peak = 0.0;
+    int64_t zeroCrossings = 0;
+    double lastSample = 0.0; // carries sign changes across block boundaries
+};
+
+// Every channel of the main input and output buses
 struct RunStats {
-    double sumSqInL = 0.0;
-    double sumSqInR = 0.0;
-    double sumSqOutL = 0.0;
-    double sumSqOutR = 0.0;
-    float peakInL = 0.0f;
-    float peakInR = 0.0f;
-    float peakOutL = 0.0f;
-    float peakOutR = 0.0f;
+    std::vector<ChannelStats> inputs;
+    std::vector<ChannelStats> outputs;
     int64_t sampleCount = 0;
 };
 
@@ -25,10 +37,18 @@ struct RmsPeakAnalyzer : public Analyzer {
     void processBlock(const BlockContext& ctx) override;
     void finish(const juce::File& outDir) override;
 
+    // AnalyzerPipeline stage interface
+    void beginBlock(const BlockContext& ctx);
+    void processSamples(const BlockContext& ctx, int start, int numSamples);
+    void endBlock(const BlockContext& ctx);
+
 private:
     std::map<int, RunStats> perRunStats;
+    RunStats* currentStats = nullptr; // stats of the block being processed
     std::map<int, std::map<juce::String, float>> runParamValues; // runId -> paramName -> value
     std::map<int, float> runInputGainDb;                         // runId -> inputGainDb
+    std::vector<juce::String> inputNames{"L", "R"};              // column names of the widest buses seen
+    std::vector<juce::String> outputNames{"L", "R"};
     std::vector<juce::String> paramNames;
     juce::File outputDir;
     juce::String signalType;
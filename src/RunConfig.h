@@ -7,4 +7,8 @@ struct RunConfig {
     int runId;
     std::map<juce::String, float> paramValues; // paramName -> normalized [0,1] value
     float inputGainDb;
+    int sourceRunId = -1;    // measured run with an equivalent discrete-parameter setting whose output this run reuses
+    double sampleRate = 0.0; // host configuration; 0 uses the grid's sample rate / block size
+    int blockSize = 0;
+    bool doublePrecision = false; // processBlock(AudioBuffer<double>&) when the plugin supports it
 };
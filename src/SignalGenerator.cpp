@@ -1,70 +1,367 @@
 #include "SignalGenerator.h"
+#include <algorithm>
 #include <cmath>
 
-void SineGenerator::fillBlock(juce::AudioBuffer<float>& buffer, int numSamples) {
-    const double phaseIncrement = 2.0 * juce::MathConstants<double>::pi * frequency / sampleRate;
+template <typename SampleType>
+static void copyFirstChannel(juce::AudioBuffer<SampleType>& buffer, int numSamples) {
+    for (int ch = 1; ch < buffer.getNumChannels(); ++ch)
+        buffer.copyFrom(ch, 0, buffer, 0, 0, numSamples);
+}
+
+uint64_t deriveRunSeed(uint64_t baseSeed, int runId) {
+    // splitmix64 finaliser over the base seed and run id
+    uint64_t z = baseSeed + 0x9E3779B97F4A7C15ull * (uint64_t)(uint32_t)(runId + 1);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
 
-    for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
-        auto* channelData = buffer.getWritePointer(ch);
-        double currentPhase = phase;
+template <typename SampleType>
+void SineGenerator::fillBlock(juce::AudioBuffer<SampleType>& buffer, int numSamples) {
+    if (buffer.getNumChannels() == 0 || numSamples <= 0)
+        return;
 
-        for (int i = 0; i < numSamples; ++i) {
-            channelData[i] = amplitude * (float)std::sin(currentPhase);
-            currentPhase += phaseIncrement;
+    const double twoPi = 2.0 * juce::MathConstants<double>::pi;
+    const double phaseIncrement = twoPi * frequency / sampleRate;
+
+    // Lane l starts l samples ahead; every lane then rotates by four samples per step
+    constexpr int lanes = 4;
+    double re[lanes], im[lanes];
+    for (int l = 0; l < lanes; ++l) {
+        re[l] = std::cos(phase + phaseIncrement * (double)l);
+        im[l] = std::sin(phase + phaseIncrement * (double)l);
+    }
+    const double stepRe = std::cos(phaseIncrement * (double)lanes);
+    const double stepIm = std::sin(phaseIncrement * (double)lanes);
 
-            if (currentPhase > 2.0 * juce::MathConstants<double>::pi)
-                currentPhase -= 2.0 * juce::MathConstants<double>::pi;
+    auto* out = buffer.getWritePointer(0);
+    int i = 0;
+    for (; i + lanes <= numSamples; i += lanes) {
+        for (int l = 0; l < lanes; ++l) {
+            out[i + l] = (SampleType)amplitude * (SampleType)im[l];
+            const double nextRe = re[l] * stepRe - im[l] * stepIm;
+            im[l] = im[l] * stepRe + re[l] * stepIm;
+            re[l] = nextRe;
         }
     }
+    for (int l = 0; i < numSamples; ++i, ++l)
+        out[i] = (SampleType)amplitude * (SampleType)im[l];
 
-    phase += phaseIncrement * numSamples;
-    if (phase > 2.0 * juce::MathConstants<double>::pi)
-        phase -= 2.0 * juce::MathConstants<double>::pi;
+    phase = std::fmod(phase + phaseIncrement * (double)numSamples, twoPi);
+    copyFirstChannel(buffer, numSamples);
 }
 
-void NoiseGenerator::fillBlock(juce::AudioBuffer<float>& buffer, int numSamples) {
-    for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
-        auto* channelData = buffer.getWritePointer(ch);
-        for (int i = 0; i < numSamples; ++i) {
-            // Generate white noise in range [-amplitude, amplitude]
-            channelData[i] = amplitude * (2.0f * rng.nextFloat() - 1.0f);
-        }
+// Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3")
+static void philox4x32(uint64_t counter, uint64_t seed, uint32_t result[4]) {
+    uint32_t c0 = (uint32_t)counter, c1 = (uint32_t)(counter >> 32), c2 = 0, c3 = 0;
+    uint32_t k0 = (uint32_t)seed, k1 = (uint32_t)(seed >> 32);
+
+    for (int round = 0; round < 10; ++round) {
+        const uint64_t p0 = (uint64_t)0xD2511F53u * c0;
+        const uint64_t p1 = (uint64_t)0xCD9E8D57u * c2;
+        const uint32_t n0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+        const uint32_t n2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+        c1 = (uint32_t)p1;
+        c3 = (uint32_t)p0;
+        c0 = n0;
+        c2 = n2;
+        k0 += 0x9E3779B9u;
+        k1 += 0xBB67AE85u;
     }
+
+    result[0] = c0;
+    result[1] = c1;
+    result[2] = c2;
+    result[3] = c3;
+}
+
+void NoiseGenerator::reset() {
+    sampleIndex = 0;
+}
+
+template <typename SampleType>
+void NoiseGenerator::fillBlock(juce::AudioBuffer<SampleType>& buffer, int numSamples) {
+    if (buffer.getNumChannels() == 0 || numSamples <= 0)
+        return;
+
+    // Each counter value yields four samples; signed 32-bit words map onto [-1, 1)
+    const SampleType scale = (SampleType)amplitude / (SampleType)2147483648.0;
+    auto* out = buffer.getWritePointer(0);
+    uint32_t words[4];
+    int i = 0;
+    while (i < numSamples) {
+        const uint64_t index = sampleIndex + (uint64_t)i;
+        philox4x32(index >> 2, seed, words);
+
+        for (int w = (int)(index & 3); w < 4 && i < numSamples; ++w, ++i)
+            out[i] = scale * (SampleType)(int32_t)words[w];
+    }
+
+    sampleIndex += (uint64_t)numSamples;
+    copyFirstChannel(buffer, numSamples);
+}
+
+void MlsGenerator::generate(int order, std::vector<uint8_t>& bitsOut, std::vector<uint32_t>& statesOut) {
+    // Fibonacci LFSR feedback taps (bit positions) of primitive polynomials, indexed by order
+    static const uint32_t tapMasks[maxOrder + 1] = {
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        (1u << 0) | (1u << 3),                            // 10: x^10 + x^7 + 1
+        (1u << 0) | (1u << 2),                            // 11: x^11 + x^9 + 1
+        (1u << 0) | (1u << 6) | (1u << 8) | (1u << 11),   // 12: x^12 + x^6 + x^4 + x + 1
+        (1u << 0) | (1u << 9) | (1u << 10) | (1u << 12),  // 13: x^13 + x^4 + x^3 + x + 1
+        (1u << 0) | (1u << 9) | (1u << 11) | (1u << 13),  // 14: x^14 + x^5 + x^3 + x + 1
+        (1u << 0) | (1u << 1),                            // 15: x^15 + x^14 + 1
+        (1u << 0) | (1u << 1) | (1u << 3) | (1u << 12),   // 16: x^16 + x^15 + x^13 + x^4 + 1
+        (1u << 0) | (1u << 3),                            // 17: x^17 + x^14 + 1
+        (1u << 0) | (1u << 7),                            // 18: x^18 + x^11 + 1
+        (1u << 0) | (1u << 13) | (1u << 17) | (1u << 18), // 19: x^19 + x^6 + x^2 + x + 1
+        (1u << 0) | (1u << 3),                            // 20: x^20 + x^17 + 1
+    };
+
+    order = std::clamp(order, (int)minOrder, (int)maxOrder);
+    const int length = (1 << order) - 1;
+    const uint32_t taps = tapMasks[order];
+
+    bitsOut.resize(length);
+    statesOut.resize(length);
+
+    uint32_t state = 1;
+    for (int n = 0; n < length; ++n) {
+        statesOut[n] = state;
+        bitsOut[n] = (uint8_t)(state & 1u);
+
+        uint32_t feedback = state & taps;
+        feedback ^= feedback >> 16;
+        feedback ^= feedback >> 8;
+        feedback ^= feedback >> 4;
+        feedback ^= feedback >> 2;
+        feedback ^= feedback >> 1;
+        state = (state >> 1) | ((feedback & 1u) << (order - 1));
+    }
+}
+
+void MlsGenerator::reset() {
+    std::vector<uint32_t> states;
+    generate(order, bits, states);
+    position = 0;
+}
+
+template <typename SampleType>
+void MlsGenerator::fillBlock(juce::AudioBuffer<SampleType>& buffer, int numSamples) {
+    if (bits.empty())
+        return;
+
+    if (buffer.getNumChannels() == 0 || numSamples <= 0)
+        return;
+
+    const int length = (int)bits.size();
+    auto* out = buffer.getWritePointer(0);
+    for (int i = 0; i < numSamples; ++i) {
+        out[i] = (SampleType)(bits[position] ? -amplitude : amplitude);
+        if (++position >= length)
+            position = 0;
+    }
+
+    copyFirstChannel(buffer, numSamples);
 }
 
 void SweepGenerator::reset() {
-    currentPhase = 0.0;
-    currentFreq = startHz;
     currentSample = 0;
 }
 
-void SweepGenerator::fillBlock(juce::AudioBuffer<float>& buffer, int numSamples) {
+template <typename SampleType>
+void SweepGenerator::fillBlock(juce::AudioBuffer<SampleType>& buffer, int numSamples) {
+    if (buffer.getNumChannels() == 0 || numSamples <= 0)
+        return;
+
+    const double twoPi = 2.0 * juce::MathConstants<double>::pi;
     const int64_t totalSamples = (int64_t)(duration * sampleRate);
-    const double logStart = std::log(startHz);
-    const double logEnd = std::log(endHz);
+    const double sweepRate = std::log(endHz / startHz); // ln(f2 / f1)
+
+    auto* out = buffer.getWritePointer(0);
+    const int active = (int)std::clamp<int64_t>(totalSamples - currentSample, 0, (int64_t)numSamples);
 
-    for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
-        auto* channelData = buffer.getWritePointer(ch);
+    if (std::abs(sweepRate) < 1e-12) {
+        const double phaseIncrement = twoPi * startHz / sampleRate;
+        for (int i = 0; i < active; ++i)
+            out[i] = (SampleType)amplitude * (SampleType)std::sin(phaseIncrement * (double)(currentSample + i));
+    } else {
+        // phi(n) = K * (g^n - 1) with g = exp(ln(f2 / f1) / N). g^n is anchored once per block and advanced
+        // by multiplication in four lanes.
+        const double K = twoPi * startHz * (double)totalSamples / (sampleRate * sweepRate);
+        const double growth = std::exp(sweepRate / (double)totalSamples);
 
-        for (int i = 0; i < numSamples; ++i) {
-            if (currentSample >= totalSamples) {
-                channelData[i] = 0.0f;
-                continue;
+        constexpr int lanes = 4;
+        double envelope[lanes];
+        const double anchor = std::exp(sweepRate * (double)currentSample / (double)totalSamples);
+        for (int l = 0; l < lanes; ++l)
+            envelope[l] = anchor * std::pow(growth, (double)l);
+        const double laneStep = std::pow(growth, (double)lanes);
+
+        int i = 0;
+        for (; i + lanes <= active; i += lanes) {
+            for (int l = 0; l < lanes; ++l) {
+                out[i + l] = (SampleType)amplitude * (SampleType)std::sin(K * (envelope[l] - 1.0));
+                envelope[l] *= laneStep;
             }
+        }
+        for (int l = 0; i < active; ++i, ++l)
+            out[i] = (SampleType)amplitude * (SampleType)std::sin(K * (envelope[l] - 1.0));
+    }
 
-            // Logarithmic sweep
-            double t = (double)currentSample / (double)totalSamples;
-            double logFreq = logStart + t * (logEnd - logStart);
-            currentFreq = std::exp(logFreq);
+    std::fill(out + active, out + numSamples, (SampleType)0);
 
-            const double phaseIncrement = 2.0 * juce::MathConstants<double>::pi * currentFreq / sampleRate;
-            channelData[i] = amplitude * (float)std::sin(currentPhase);
+    currentSample += numSamples;
+    copyFirstChannel(buffer, numSamples);
+}
 
-            currentPhase += phaseIncrement;
-            if (currentPhase > 2.0 * juce::MathConstants<double>::pi)
-                currentPhase -= 2.0 * juce::MathConstants<double>::pi;
+std::vector<float> StaircaseGenerator::buildSteps(std::vector<float> levelsDb) {
+    std::sort(levelsDb.begin(), levelsDb.end());
+    levelsDb.erase(std::unique(levelsDb.begin(), levelsDb.end()), levelsDb.end());
 
-            currentSample++;
+    std::vector<float> steps = levelsDb;
+    for (int i = (int)levelsDb.size() - 2; i >= 0; --i)
+        steps.push_back(levelsDb[i]);
+    return steps;
+}
+
+int64_t StaircaseGenerator::stepLength(double duration, double sampleRate, int numSteps) {
+    return std::max<int64_t>(1, (int64_t)(duration * sampleRate) / std::max(1, numSteps));
+}
+
+void StaircaseGenerator::reset() {
+    tone.sampleRate = sampleRate;
+    tone.frequency = frequency;
+    tone.amplitude = 1.0f;
+    tone.phase = 0.0;
+    currentSample = 0;
+}
+
+template <typename SampleType>
+void StaircaseGenerator::fillBlock(juce::AudioBuffer<SampleType>& buffer, int numSamples) {
+    if (stepsDb.empty())
+        return;
+
+    if (buffer.getNumChannels() == 0 || numSamples <= 0)
+        return;
+
+    // Unit tone, then each stretch of the block belonging to one step is scaled by that step's level
+    tone.fillBlock(buffer, numSamples);
+
+    const int numSteps = (int)stepsDb.size();
+    const int64_t stepSamples = stepLength(duration, sampleRate, numSteps);
+    auto* out = buffer.getWritePointer(0);
+    int i = 0;
+    while (i < numSamples) {
+        const int64_t position = currentSample + i;
+        const int step = (int)std::min<int64_t>(position / stepSamples, numSteps - 1);
+        const int64_t stepEnd = step == numSteps - 1 ? position + numSamples : (int64_t)(step + 1) * stepSamples;
+        const int count = (int)std::min<int64_t>(numSamples - i, stepEnd - position);
+
+        const SampleType gain =
+            (SampleType)amplitude * std::pow((SampleType)10, (SampleType)stepsDb[step] / (SampleType)20);
+        for (int j = 0; j < count; ++j)
+            out[i + j] *= gain;
+        i += count;
+    }
+
+    currentSample += numSamples;
+    copyFirstChannel(buffer, numSamples);
+}
+
+std::vector<MultiToneGenerator::Tone> MultiToneGenerator::buildTones(const juce::String& preset, double startHz,
+                                                                     double endHz, int numTones, int periodLength,
+                                                                     double sampleRate) {
+    const double binHz = sampleRate / (double)periodLength;
+    const int maxBin = periodLength / 2 - 1;
+    auto toBin = [&](double freq) { return std::clamp((int)std::round(freq / binHz), 1, maxBin); };
+
+    std::vector<Tone> result;
+
+    if (preset.equalsIgnoreCase("smpte")) {
+        result.push_back({toBin(60.0), 1.0f, 0.0});
+        result.push_back({toBin(7000.0), 0.25f, 0.0});
+        return result;
+    }
+
+    if (preset.equalsIgnoreCase("ccif")) {
+        result.push_back({toBin(19000.0), 1.0f, 0.0});
+        result.push_back({toBin(20000.0), 1.0f, 0.0});
+        return result;
+    }
+
+    // Log-spaced tones, snapped to bins and de-duplicated
+    numTones = std::max(1, numTones);
+    const double logStart = std::log(std::max(startHz, binHz));
+    const double logEnd = std::log(std::max(endHz, startHz));
+    int lastBin = 0;
+    for (int i = 0; i < numTones; ++i) {
+        const double t = numTones > 1 ? (double)i / (double)(numTones - 1) : 0.0;
+        const int bin = toBin(std::exp(logStart + t * (logEnd - logStart)));
+        if (bin > lastBin) {
+            result.push_back({bin, 1.0f, 0.0});
+            lastBin = bin;
         }
     }
+
+    // Schroeder phases keep the crest factor of equal-amplitude tones low
+    const int K = (int)result.size();
+    for (int k = 0; k < K; ++k)
+        result[k].phase = -juce::MathConstants<double>::pi * (double)k * (double)(k + 1) / (double)K;
+
+    return result;
+}
+
+void MultiToneGenerator::reset() {
+    period.assign(periodLength, 0.0);
+    position = 0;
+
+    std::vector<double> sum(periodLength, 0.0);
+    for (const auto& tone : tones) {
+        const double w = 2.0 * juce::MathConstants<double>::pi * (double)tone.bin / (double)periodLength;
+        for (int n = 0; n < periodLength; ++n)
+            sum[n] += (double)tone.amplitude * std::cos(w * (double)n + tone.phase);
+    }
+
+    double peak = 0.0;
+    for (double v : sum)
+        peak = std::max(peak, std::abs(v));
+
+    const double scale = peak > 0.0 ? (double)amplitude / peak : 0.0;
+    for (int n = 0; n < periodLength; ++n)
+        period[n] = sum[n] * scale;
 }
+
+template <typename SampleType>
+void MultiToneGenerator::fillBlock(juce::AudioBuffer<SampleType>& buffer, int numSamples) {
+    if (period.empty())
+        return;
+
+    if (buffer.getNumChannels() == 0 || numSamples <= 0)
+        return;
+
+    auto* out = buffer.getWritePointer(0);
+    int i = 0;
+    while (i < numSamples) {
+        const int toCopy = std::min(numSamples - i, periodLength - position);
+        for (int j = 0; j < toCopy; ++j)
+            out[i + j] = (SampleType)period[position + j];
+        position = (position + toCopy) % periodLength;
+        i += toCopy;
+    }
+
+    copyFirstChannel(buffer, numSamples);
+}
+
+template void SineGenerator::fillBlock(juce::AudioBuffer<float>&, int);
+template void SineGenerator::fillBlock(juce::AudioBuffer<double>&, int);
+template void NoiseGenerator::fillBlock(juce::AudioBuffer<float>&, int);
+template void NoiseGenerator::fillBlock(juce::AudioBuffer<double>&, int);
+template void MlsGenerator::fillBlock(juce::AudioBuffer<float>&, int);
+template void MlsGenerator::fillBlock(juce::AudioBuffer<double>&, int);
+template void SweepGenerator::fillBlock(juce::AudioBuffer<float>&, int);
+template void SweepGenerator::fillBlock(juce::AudioBuffer<double>&, int);
+template void StaircaseGenerator::fillBlock(juce::AudioBuffer<float>&, int);
+template void StaircaseGenerator::fillBlock(juce::AudioBuffer<double>&, int);
+template void MultiToneGenerator::fillBlock(juce::AudioBuffer<float>&, int);
+template void MultiToneGenerator::fillBlock(juce::AudioBuffer<double>&, int);
@@ -2,23 +2,61 @@
 
 #include "JuceHeader.h"
 #include <cstdint>
+#include <vector>
 
+// Seed for a run's random stimulus, derived from the configured base seed and the run id so that any
+// run renders the same samples whether it is run alone, resumed or scheduled in a different order
+uint64_t deriveRunSeed(uint64_t baseSeed, int runId);
+
+// Generators render one channel and copy it to the others, so every channel carries the same stimulus.
+// fillBlock() takes float or double buffers; samples are computed in double and rounded once to the buffer's type.
+
+// Sine from four interleaved quadrature oscillators (complex rotation, no per-sample sin), re-anchored
+// from the accumulated phase at the start of every block
 struct SineGenerator {
     double sampleRate = 48000.0;
     double frequency = 1000.0;
     double phase = 0.0;
     float amplitude = 0.5f;
 
-    void fillBlock(juce::AudioBuffer<float>& buffer, int numSamples);
+    template <typename SampleType>
+    void fillBlock(juce::AudioBuffer<SampleType>& buffer, int numSamples);
 };
 
+// Uniform white noise in [-amplitude, amplitude) from the Philox4x32-10 counter-based generator: sample n
+// depends only on (seed, n), so the sequence is reproducible and can be rendered four samples at a time
 struct NoiseGenerator {
     float amplitude = 0.5f;
-    juce::Random rng;
+    uint64_t seed = 0;
+    uint64_t sampleIndex = 0;
 
-    void fillBlock(juce::AudioBuffer<float>& buffer, int numSamples);
+    void reset();
+    template <typename SampleType>
+    void fillBlock(juce::AudioBuffer<SampleType>& buffer, int numSamples);
 };
 
+// Maximum-length sequence (+/-amplitude), repeated periodically. Order m gives a period of 2^m - 1
+// samples. The bits and LFSR states are exposed so the analyzer can build the Hadamard permutations.
+struct MlsGenerator {
+    static constexpr int minOrder = 10;
+    static constexpr int maxOrder = 20;
+
+    int order = 15;
+    float amplitude = 0.5f;
+
+    std::vector<uint8_t> bits;
+    int position = 0;
+
+    // bitsOut[n] is the output bit at step n and statesOut[n] the (nonzero) register contents it came from
+    static void generate(int order, std::vector<uint8_t>& bitsOut, std::vector<uint32_t>& statesOut);
+
+    void reset();
+    template <typename SampleType>
+    void fillBlock(juce::AudioBuffer<SampleType>& buffer, int numSamples);
+};
+
+// Exponential sweep with the closed-form phase 2*pi*f1*T/ln(f2/f1) * (exp(t/T * ln(f2/f1)) - 1), so the
+// phase at any sample is exact rather than accumulated; silent after the sweep duration
 struct SweepGenerator {
     double sampleRate = 48000.0;
     double startHz = 20.0;
@@ -26,10 +64,61 @@ struct SweepGenerator {
     double duration = 5.0;
     float amplitude = 0.5f;
 
-    double currentPhase = 0.0;
-    double currentFreq = 20.0;
     int64_t currentSample = 0;
 
     void reset();
-    void fillBlock(juce::AudioBuffer<float>& buffer, int numSamples);
+    template <typename SampleType>
+    void fillBlock(juce::AudioBuffer<SampleType>& buffer, int numSamples);
+};
+
+// Sine tone stepping through a level staircase: up through the levels in ascending order and back down,
+// each step holding for an equal share of the duration (the remainder repeats the last step). Every rising
+// step is an attack event for a compressor and every falling step a release event.
+struct StaircaseGenerator {
+    double sampleRate = 48000.0;
+    double frequency = 1000.0;
+    double duration = 5.0;
+    float amplitude = 1.0f;     // scales every step level
+    std::vector<float> stepsDb; // peak level of each step, from buildSteps()
+
+    SineGenerator tone;
+    int64_t currentSample = 0;
+
+    // Sorted, de-duplicated levels up and back down again: {-40, -20, 0} -> {-40, -20, 0, -20, -40}
+    static std::vector<float> buildSteps(std::vector<float> levelsDb);
+    static int64_t stepLength(double duration, double sampleRate, int numSteps);
+
+    void reset();
+    template <typename SampleType>
+    void fillBlock(juce::AudioBuffer<SampleType>& buffer, int numSamples);
+};
+
+// Periodic multi-tone stimulus. Every tone sits exactly on a bin of a periodLength-point FFT, so one
+// period of the response can be analysed without windowing. Presets:
+//   "log"   - numTones log-spaced between startHz and endHz, equal amplitude, Schroeder phases for low crest factor
+//   "smpte" - 60 Hz + 7 kHz at 4:1 amplitude (SMPTE RP120 IMD)
+//   "ccif"  - 19 kHz + 20 kHz at 1:1 amplitude (CCIF / ITU-R difference-frequency IMD)
+struct MultiToneGenerator {
+    static constexpr int defaultPeriodLength = 16384;
+
+    struct Tone {
+        int bin = 0;
+        float amplitude = 1.0f; // relative; the rendered period is normalised to unit peak
+        double phase = 0.0;
+    };
+
+    double sampleRate = 48000.0;
+    int periodLength = defaultPeriodLength;
+    float amplitude = 0.5f; // peak amplitude of the composite signal
+    std::vector<Tone> tones;
+
+    std::vector<double> period;
+    int position = 0;
+
+    static std::vector<Tone> buildTones(const juce::String& preset, double startHz, double endHz, int numTones,
+                                        int periodLength, double sampleRate);
+
+    void reset();
+    template <typename SampleType>
+    void fillBlock(juce::AudioBuffer<SampleType>& buffer, int numSamples);
 };
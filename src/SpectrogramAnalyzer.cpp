@@ -0,0 +1,225 @@
+#include "SpectrogramAnalyzer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+// Appends an unsigned integer in little-endian byte order, whatever the host's
+template <typename UInt>
+static void appendLittleEndian(std::vector<char>& bytes, UInt value) {
+    for (size_t i = 0; i < sizeof(UInt); ++i)
+        bytes.push_back((char)((value >> (8 * i)) & 0xff));
+}
+
+static void appendFloat(std::vector<char>& bytes, float value) {
+    uint32_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    appendLittleEndian(bytes, bits);
+}
+
+static void appendDouble(std::vector<char>& bytes, double value) {
+    uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    appendLittleEndian(bytes, bits);
+}
+
+static SpectrogramAnalyzer::Window parseWindow(const juce::String& name) {
+    if (name.equalsIgnoreCase("hamming"))
+        return SpectrogramAnalyzer::Window::hamming;
+    if (name.equalsIgnoreCase("blackman"))
+        return SpectrogramAnalyzer::Window::blackman;
+    if (name.equalsIgnoreCase("rect") || name.equalsIgnoreCase("rectangular"))
+        return SpectrogramAnalyzer::Window::rectangular;
+    if (!name.equalsIgnoreCase("hann"))
+        std::cerr << "Warning: Unknown spectrogram window '" << name << "', using hann" << std::endl;
+    return SpectrogramAnalyzer::Window::hann;
+}
+
+// FFT order for a requested size, rounded up to a power of two between 64 and 65536
+static int fftOrderFor(int fftSize) {
+    int order = 6;
+    while (order < 16 && (1 << order) < fftSize)
+        ++order;
+    return order;
+}
+
+SpectrogramAnalyzer::SpectrogramAnalyzer(const juce::File& outDir, int fftSize, int hopSize,
+                                         const juce::String& window, float floorDb,
+                                         const std::vector<juce::String>& paramNames,
+                                         const juce::String& signalType)
+    : fftSize(1 << fftOrderFor(fftSize)), numBins(this->fftSize / 2 + 1), windowType(parseWindow(window)),
+      floorDb(floorDb), paramNames(paramNames), signalType(signalType), fft(fftOrderFor(fftSize)) {
+    this->hopSize = juce::jlimit(1, this->fftSize, hopSize);
+
+    // Periodic windows, so overlapped frames at the usual hops sum to a constant
+    const double twoPi = 2.0 * juce::MathConstants<double>::pi;
+    this->window.resize(this->fftSize);
+    double windowSum = 0.0;
+    for (int i = 0; i < this->fftSize; ++i) {
+        const double phase = twoPi * (double)i / (double)this->fftSize;
+        double w = 1.0;
+        if (windowType == Window::hann)
+            w = 0.5 - 0.5 * std::cos(phase);
+        else if (windowType == Window::hamming)
+            w = 0.54 - 0.46 * std::cos(phase);
+        else if (windowType == Window::blackman)
+            w = 0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase);
+        this->window[i] = (float)w;
+        windowSum += w;
+    }
+    magnitudeScale = (float)(2.0 / windowSum);
+
+    frame.assign(this->fftSize, 0.0f);
+    scratch.assign(2 * this->fftSize, 0.0f);
+    frameBytes.reserve(2 * numBins);
+
+    const juce::String baseName = "grid_spectrogram_" + signalType.toLowerCase();
+    binFile = std::make_unique<std::ofstream>(outDir.getChildFile(baseName + ".bin").getFullPathName().toStdString(),
+                                              std::ios::binary);
+    if (!binFile->is_open()) {
+        std::cerr << "Failed to open " << baseName.toStdString() << ".bin for writing" << std::endl;
+        binFile.reset();
+        return;
+    }
+    writeHeader();
+    bytesWritten = headerBytes;
+
+    csvFile = std::make_unique<std::ofstream>(outDir.getChildFile(baseName + ".csv").getFullPathName().toStdString());
+    if (!csvFile->is_open()) {
+        std::cerr << "Failed to open " << baseName.toStdString() << ".csv for writing" << std::endl;
+        csvFile.reset();
+        return;
+    }
+    *csvFile << "runId,sampleRate,frameOffset,numFrames,fftSize,hopSize";
+    for (const auto& paramName : paramNames)
+        *csvFile << "," << paramName.toStdString();
+    *csvFile << ",inputGainDb\n";
+}
+
+SpectrogramAnalyzer::~SpectrogramAnalyzer() {}
+
+void SpectrogramAnalyzer::writeHeader() {
+    // Written with no runs at the start; finish() rewrites it once the index is known
+    std::vector<char> header;
+    for (char c : {'P', 'A', 'S', 'P', 'E', 'C', '1', '\0'})
+        header.push_back(c);
+    appendLittleEndian(header, (uint32_t)1); // version
+    appendLittleEndian(header, (uint32_t)fftSize);
+    appendLittleEndian(header, (uint32_t)hopSize);
+    appendLittleEndian(header, (uint32_t)numBins);
+    appendLittleEndian(header, (uint32_t)windowType);
+    appendLittleEndian(header, (uint32_t)runIndex.size());
+    appendLittleEndian(header, bytesWritten); // index offset: the index follows the last frame
+    appendFloat(header, floorDb);
+    appendFloat(header, dbStep);
+    header.resize(headerBytes, '\0');
+    binFile->write(header.data(), (std::streamsize)header.size());
+}
+
+void SpectrogramAnalyzer::processFrame() {
+    std::fill(scratch.begin(), scratch.end(), 0.0f);
+    for (int i = 0; i < fftSize; ++i)
+        scratch[i] = frame[i] * window[i];
+    fft.performRealOnlyForwardTransform(scratch.data(), true);
+
+    frameBytes.clear();
+    const float maxCode = 65535.0f;
+    for (int k = 0; k < numBins; ++k) {
+        // DC and Nyquist have no mirrored negative-frequency half
+        const float scale = (k == 0 || k == numBins - 1) ? 0.5f * magnitudeScale : magnitudeScale;
+        const float magnitude = std::hypot(scratch[2 * k], scratch[2 * k + 1]) * scale;
+        float code = 0.0f;
+        if (magnitude > 0.0f)
+            code = std::clamp(std::round((20.0f * std::log10(magnitude) - floorDb) / dbStep), 0.0f, maxCode);
+        appendLittleEndian(frameBytes, (uint16_t)code);
+    }
+
+    if (binFile)
+        binFile->write(frameBytes.data(), (std::streamsize)frameBytes.size());
+    bytesWritten += frameBytes.size();
+    current.numFrames++;
+
+    // Keep the overlapping tail for the next frame
+    std::copy(frame.begin() + hopSize, frame.end(), frame.begin());
+    frameFill = fftSize - hopSize;
+}
+
+void SpectrogramAnalyzer::processRun() {
+    runIndex.push_back(current);
+
+    if (!csvFile)
+        return;
+
+    auto& out = *csvFile;
+    out << current.runId << "," << current.sampleRate << "," << current.frameOffset << "," << current.numFrames
+        << "," << fftSize << "," << hopSize;
+    for (const auto& paramName : paramNames) {
+        float value = 0.0f;
+        auto it = currentParamValues.find(paramName);
+        if (it != currentParamValues.end())
+            value = it->second;
+        out << "," << value;
+    }
+    out << "," << currentInputGainDb << "\n";
+}
+
+void SpectrogramAnalyzer::processBlock(const BlockContext& ctx) {
+    // A new run id means the previous run is complete
+    if (ctx.runId != current.runId) {
+        if (current.runId >= 0)
+            processRun();
+        current = RunIndexEntry();
+        current.runId = ctx.runId;
+        current.frameOffset = bytesWritten;
+        current.sampleRate = ctx.sampleRate;
+        currentParamValues = ctx.paramNamedValues;
+        currentInputGainDb = ctx.inputGainDb;
+        frameFill = 0;
+    }
+
+    int i = 0;
+    while (i < ctx.numSamples) {
+        const int toCopy = std::min(fftSize - frameFill, ctx.numSamples - i);
+        std::copy(ctx.outL + i, ctx.outL + i + toCopy, frame.begin() + frameFill);
+        frameFill += toCopy;
+        i += toCopy;
+
+        if (frameFill == fftSize)
+            processFrame();
+    }
+}
+
+void SpectrogramAnalyzer::finish(const juce::File& outDir) {
+    if (current.runId >= 0) {
+        processRun();
+        current = RunIndexEntry();
+    }
+
+    if (binFile) {
+        std::vector<char> index;
+        for (const auto& entry : runIndex) {
+            appendLittleEndian(index, (uint32_t)entry.runId);
+            appendLittleEndian(index, entry.numFrames);
+            appendLittleEndian(index, entry.frameOffset);
+            appendDouble(index, entry.sampleRate);
+        }
+        binFile->write(index.data(), (std::streamsize)index.size());
+
+        binFile->seekp(0);
+        writeHeader();
+        binFile->close();
+        binFile.reset();
+    }
+
+    if (csvFile) {
+        csvFile->close();
+        csvFile.reset();
+    }
+}
+
+std::unique_ptr<Analyzer> createSpectrogramAnalyzer(const juce::File& outDir, int fftSize, int hopSize,
+                                                    const juce::String& window, float floorDb,
+                                                    const std::vector<juce::String>& paramNames,
+                                                    const juce::String& signalType) {
+    return std::make_unique<SpectrogramAnalyzer>(outDir, fftSize, hopSize, window, floorDb, paramNames, signalType);
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Analyzer.h"
+#include "JuceHeader.h"
+#include <fstream>
+#include <map>
+#include <memory>
+#include <vector>
+
+// Streaming short-time Fourier transform of the first output channel, for behaviour that changes over a run
+// (modulation, gating, envelope pumping). Frames of fftSize samples, hopSize apart, are windowed and their
+// magnitude spectrum (bins 0..fftSize/2, a full-scale sine on a bin reads 0 dB) is quantised to uint16:
+// code = round((dB - floorDb) / dbStep), with 0 at or below floorDb and dbStep = 0.01 dB. Only the frame in
+// progress is buffered and frames go straight to disk, so memory does not depend on run length. A trailing
+// partial frame is dropped.
+//
+// grid_spectrogram_<signal>.bin, little-endian, laid out to be memory-mapped:
+//   header, 64 bytes: char[8] "PASPEC1", uint32 version, fftSize, hopSize, numBins, window, numRuns,
+//                     uint64 indexOffset, float32 floorDb, dbStep, zero padding
+//   frames:           numBins uint16 per frame, runs one after another
+//   run index:        at indexOffset, per run int32 runId, uint32 numFrames, uint64 frameOffset (bytes),
+//                     float64 sampleRate
+// grid_spectrogram_<signal>.csv repeats the run index with each run's parameters.
+struct SpectrogramAnalyzer : public Analyzer {
+    enum class Window { hann = 0, hamming = 1, blackman = 2, rectangular = 3 };
+
+    static constexpr int headerBytes = 64;
+    static constexpr int indexEntryBytes = 24;
+    static constexpr float dbStep = 0.01f;
+
+    SpectrogramAnalyzer(const juce::File& outDir, int fftSize, int hopSize, const juce::String& window,
+                        float floorDb, const std::vector<juce::String>& paramNames, const juce::String& signalType);
+    ~SpectrogramAnalyzer() override;
+
+    void processBlock(const BlockContext& ctx) override;
+    void finish(const juce::File& outDir) override;
+
+private:
+    struct RunIndexEntry {
+        int runId = -1;
+        uint32_t numFrames = 0;
+        uint64_t frameOffset = 0;
+        double sampleRate = 0.0;
+    };
+
+    int fftSize;
+    int hopSize;
+    int numBins;
+    Window windowType;
+    float floorDb;
+    std::vector<juce::String> paramNames;
+    juce::String signalType;
+
+    juce::dsp::FFT fft;
+    std::vector<float> window;
+    float magnitudeScale = 1.0f;  // 2 / sum(window): a full-scale sine on a bin reads 1
+    std::vector<float> frame;     // fftSize samples of the frame in progress
+    int frameFill = 0;            // samples of frame filled so far
+    std::vector<float> scratch;   // 2 * fftSize, real-only FFT workspace
+    std::vector<char> frameBytes; // one quantised frame, little-endian
+
+    RunIndexEntry current;
+    std::map<juce::String, float> currentParamValues;
+    float currentInputGainDb = 0.0f;
+    std::vector<RunIndexEntry> runIndex;
+    uint64_t bytesWritten = 0;
+
+    std::unique_ptr<std::ofstream> binFile;
+    std::unique_ptr<std::ofstream> csvFile;
+
+    void writeHeader();
+    void processFrame();
+    void processRun();
+};
+
+std::unique_ptr<Analyzer> createSpectrogramAnalyzer(const juce::File& outDir, int fftSize, int hopSize,
+                                                    const juce::String& window, float floorDb,
+                                                    const std::vector<juce::String>& paramNames,
+                                                    const juce::String& signalType);
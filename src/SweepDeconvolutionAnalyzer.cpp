@@ -0,0 +1,315 @@
+#include "SweepDeconvolutionAnalyzer.h"
+#include "SignalGenerator.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+SweepDeconvolutionAnalyzer::SweepDeconvolutionAnalyzer(const juce::File& outDir, double startHz, double endHz,
+                                                       double sweepSeconds,
+                                                       const std::vector<juce::String>& paramNames,
+                                                       const juce::String& signalType)
+    : startHz(startHz), endHz(endHz), sweepSeconds(sweepSeconds), paramNames(paramNames), signalType(signalType) {
+    juce::String responseName = "grid_sweep_response_" + signalType.toLowerCase() + ".csv";
+    responseFile = std::make_unique<std::ofstream>(outDir.getChildFile(responseName).getFullPathName().toStdString());
+    if (!responseFile->is_open()) {
+        std::cerr << "Failed to open " << responseName.toStdString() << " for writing" << std::endl;
+        responseFile.reset();
+    }
+
+    juce::String irName = "grid_sweep_ir_" + signalType.toLowerCase() + ".csv";
+    irFile = std::make_unique<std::ofstream>(outDir.getChildFile(irName).getFullPathName().toStdString());
+    if (!irFile->is_open()) {
+        std::cerr << "Failed to open " << irName.toStdString() << " for writing" << std::endl;
+        irFile.reset();
+    }
+
+    // Headers
+    if (responseFile) {
+        *responseFile << "runId,freqHz,magDb,phaseDeg,thd";
+        for (int h = 2; h <= maxHarmonic; ++h)
+            *responseFile << ",h" << h << "Dbc";
+        for (const auto& paramName : paramNames)
+            *responseFile << "," << paramName.toStdString();
+        *responseFile << ",inputGainDb\n";
+    }
+
+    if (irFile) {
+        *irFile << "runId,sample,timeMs";
+        for (int h = 1; h <= maxHarmonic; ++h)
+            *irFile << ",h" << h;
+        for (const auto& paramName : paramNames)
+            *irFile << "," << paramName.toStdString();
+        *irFile << ",inputGainDb\n";
+    }
+}
+
+SweepDeconvolutionAnalyzer::~SweepDeconvolutionAnalyzer() {}
+
+static int largestPowerOfTwoAtMost(int n) {
+    int p = 1;
+    while (p * 2 <= n)
+        p *= 2;
+    return p;
+}
+
+void SweepDeconvolutionAnalyzer::prepare(double sampleRate) {
+    preparedSampleRate = sampleRate;
+
+    // Same length the generator uses for the sweep
+    sweepLength = std::max(1, (int)(sweepSeconds * sampleRate));
+    const double sweepRate = std::log(endHz / startHz);
+
+    // Harmonic h peaks N * ln(h) / ln(f2 / f1) samples ahead of the linear response. Keep only harmonics
+    // whose gap to the next lower one leaves room for a usable impulse response.
+    numHarmonics = 1;
+    int gap = sweepLength;
+    for (int h = maxHarmonic; h >= 2; --h) {
+        const int hGap = (int)((double)sweepLength * std::log((double)h / (double)(h - 1)) / sweepRate);
+        if (hGap >= 1024) {
+            numHarmonics = h;
+            gap = hGap;
+            break;
+        }
+    }
+
+    irLength = largestPowerOfTwoAtMost(std::clamp(gap, 64, 16384));
+    irPreSamples = irLength / 16;
+    captureLength = sweepLength + irLength;
+
+    harmonicOffsets.assign(maxHarmonic + 1, 0);
+    for (int h = 1; h <= numHarmonics; ++h) {
+        const int advance = (int)std::round((double)sweepLength * std::log((double)h) / sweepRate);
+        harmonicOffsets[h] = sweepLength - 1 - advance;
+    }
+
+    // Render the reference sweep with the same generator the engine drives
+    juce::AudioBuffer<float> reference(1, sweepLength);
+    SweepGenerator sweepGen;
+    sweepGen.sampleRate = sampleRate;
+    sweepGen.startHz = startHz;
+    sweepGen.endHz = endHz;
+    sweepGen.duration = sweepSeconds;
+    sweepGen.amplitude = 1.0f;
+    sweepGen.reset();
+    sweepGen.fillBlock(reference, sweepLength);
+    const float* ref = reference.getReadPointer(0);
+
+    // Full linear convolution of the captured signal with the N-sample inverse filter
+    int convOrder = 1;
+    while ((1 << convOrder) < captureLength + sweepLength - 1)
+        ++convOrder;
+    const int convSize = 1 << convOrder;
+    convFft = std::make_unique<juce::dsp::FFT>(convOrder);
+    convScratch.assign(2 * convSize, 0.0f);
+
+    // Inverse filter: time-reversed sweep with a -6 dB/oct envelope to undo the sweep's pink spectrum
+    for (int n = 0; n < sweepLength; ++n) {
+        const double envelope = std::exp(-sweepRate * (double)n / (double)sweepLength);
+        convScratch[n] = ref[sweepLength - 1 - n] * (float)envelope;
+    }
+    convFft->performRealOnlyForwardTransform(convScratch.data(), true);
+
+    inverseSpectrum.resize(convSize / 2 + 1);
+    for (int k = 0; k <= convSize / 2; ++k)
+        inverseSpectrum[k] = {convScratch[2 * k], convScratch[2 * k + 1]};
+
+    // Impulse response window: short half-Hann fade-in before the peak, half-Hann fade-out on the last quarter
+    int irOrder = 0;
+    while ((1 << irOrder) < irLength)
+        ++irOrder;
+    irFft = std::make_unique<juce::dsp::FFT>(irOrder);
+
+    irWindow.assign(irLength, 1.0f);
+    const int fadeOut = irLength / 4;
+    for (int i = 0; i < irPreSamples; ++i)
+        irWindow[i] = 0.5f * (1.0f - std::cos(juce::MathConstants<float>::pi * (float)i / (float)irPreSamples));
+    for (int i = 0; i < fadeOut; ++i)
+        irWindow[irLength - fadeOut + i] =
+            0.5f * (1.0f + std::cos(juce::MathConstants<float>::pi * (float)i / (float)fadeOut));
+}
+
+void SweepDeconvolutionAnalyzer::deconvolve(const std::vector<float>& signal, std::vector<float>& result) {
+    const int convSize = convFft->getSize();
+
+    std::fill(convScratch.begin(), convScratch.end(), 0.0f);
+    std::copy(signal.begin(), signal.end(), convScratch.begin());
+    convFft->performRealOnlyForwardTransform(convScratch.data(), true);
+
+    auto* bins = reinterpret_cast<std::complex<float>*>(convScratch.data());
+    for (int k = 0; k <= convSize / 2; ++k)
+        bins[k] *= inverseSpectrum[k];
+    for (int k = 1; k < convSize / 2; ++k)
+        bins[convSize - k] = std::conj(bins[k]);
+
+    convFft->performRealOnlyInverseTransform(convScratch.data());
+
+    const int resultLength = captureLength + sweepLength - 1;
+    result.assign(convScratch.begin(), convScratch.begin() + resultLength);
+}
+
+void SweepDeconvolutionAnalyzer::extractSpectrum(const std::vector<float>& deconvolved, int peak,
+                                                 std::vector<float>& ir, std::vector<std::complex<double>>& spectrum) {
+    ir.assign(irLength, 0.0f);
+    const int start = peak - irPreSamples;
+    for (int i = 0; i < irLength; ++i) {
+        const int n = start + i;
+        if (n >= 0 && n < (int)deconvolved.size())
+            ir[i] = deconvolved[n] * irWindow[i];
+    }
+
+    std::vector<float> scratch(2 * irLength, 0.0f);
+    std::copy(ir.begin(), ir.end(), scratch.begin());
+    irFft->performRealOnlyForwardTransform(scratch.data(), true);
+
+    spectrum.resize(irLength / 2 + 1);
+    for (int k = 0; k <= irLength / 2; ++k)
+        spectrum[k] = {scratch[2 * k], scratch[2 * k + 1]};
+}
+
+void SweepDeconvolutionAnalyzer::writeParams(std::ostream& out, const RunCapture& run) const {
+    for (const auto& paramName : paramNames) {
+        float value = 0.0f;
+        auto it = run.paramValues.find(paramName);
+        if (it != run.paramValues.end())
+            value = it->second;
+        out << "," << value;
+    }
+    out << "," << run.inputGainDb << "\n";
+}
+
+void SweepDeconvolutionAnalyzer::processRun() {
+    if (!responseFile && !irFile)
+        return;
+
+    current.in.resize(captureLength, 0.0f);
+    current.out.resize(captureLength, 0.0f);
+
+    std::vector<float> inDeconv, outDeconv;
+    deconvolve(current.in, inDeconv);
+    deconvolve(current.out, outDeconv);
+
+    // The deconvolved input is the sweep/inverse-filter round trip; dividing by it removes the input gain
+    // and the band-edge ripple of the inverse filter from every response
+    std::vector<float> refIr;
+    std::vector<std::complex<double>> refSpectrum;
+    extractSpectrum(inDeconv, harmonicOffsets[1], refIr, refSpectrum);
+
+    std::vector<std::vector<float>> irs(numHarmonics + 1);
+    std::vector<std::vector<std::complex<double>>> spectra(numHarmonics + 1);
+    for (int h = 1; h <= numHarmonics; ++h)
+        extractSpectrum(outDeconv, harmonicOffsets[h], irs[h], spectra[h]);
+
+    const double binHz = preparedSampleRate / (double)irLength;
+    const int numBins = irLength / 2;
+
+    // In-band reference level, used to scale the written impulse responses to unit input
+    double refLevel = 0.0;
+    int refCount = 0;
+    for (int k = 1; k < numBins; ++k) {
+        const double freq = (double)k * binHz;
+        if (freq >= startHz && freq <= endHz) {
+            refLevel += std::abs(refSpectrum[k]);
+            ++refCount;
+        }
+    }
+    if (refCount == 0 || refLevel <= 0.0)
+        return;
+    refLevel /= (double)refCount;
+
+    if (responseFile) {
+        auto& out = *responseFile;
+        for (int k = 1; k < numBins; ++k) {
+            const double freq = (double)k * binHz;
+            if (freq < startHz || freq > endHz || std::abs(refSpectrum[k]) <= 0.0)
+                continue;
+
+            const std::complex<double> H1 = spectra[1][k] / refSpectrum[k];
+            const double fundamental = std::abs(H1);
+            const double magDb = 20.0 * std::log10(std::max(fundamental, 1e-10));
+            const double phaseDeg = std::arg(H1) * 180.0 / juce::MathConstants<double>::pi;
+
+            // Harmonic h at output frequency h * f, relative to the fundamental at f
+            std::vector<double> ratio(maxHarmonic + 1, -1.0);
+            double harmonicSum = 0.0;
+            for (int h = 2; h <= numHarmonics; ++h) {
+                const int kh = h * k;
+                if (kh > numBins || (double)kh * binHz > endHz || std::abs(refSpectrum[kh]) <= 0.0)
+                    continue;
+                const double level = std::abs(spectra[h][kh]) / std::abs(refSpectrum[kh]);
+                ratio[h] = fundamental > 0.0 ? level / fundamental : 0.0;
+                harmonicSum += ratio[h] * ratio[h];
+            }
+
+            out << current.runId << "," << freq << "," << magDb << "," << phaseDeg << "," << std::sqrt(harmonicSum);
+            for (int h = 2; h <= maxHarmonic; ++h) {
+                out << ",";
+                if (ratio[h] >= 0.0)
+                    out << 20.0 * std::log10(std::max(ratio[h], 1e-10));
+            }
+            writeParams(out, current);
+        }
+    }
+
+    if (irFile) {
+        auto& out = *irFile;
+        for (int i = 0; i < irLength; ++i) {
+            const int sample = i - irPreSamples;
+            out << current.runId << "," << sample << "," << 1000.0 * (double)sample / preparedSampleRate;
+            for (int h = 1; h <= maxHarmonic; ++h) {
+                out << ",";
+                if (h <= numHarmonics)
+                    out << (double)irs[h][i] / refLevel;
+            }
+            writeParams(out, current);
+        }
+    }
+}
+
+void SweepDeconvolutionAnalyzer::processBlock(const BlockContext& ctx) {
+    // A new run id means the previous run is complete
+    if (ctx.runId != current.runId) {
+        if (current.runId >= 0)
+            processRun();
+
+        // The reference sweep, its inverse filter and the harmonic offsets are rebuilt for the new sample rate
+        if (ctx.sampleRate != preparedSampleRate)
+            prepare(ctx.sampleRate);
+
+        current.runId = ctx.runId;
+        current.paramValues = ctx.paramNamedValues;
+        current.inputGainDb = ctx.inputGainDb;
+        current.in.clear();
+        current.out.clear();
+        current.in.reserve(captureLength);
+        current.out.reserve(captureLength);
+    }
+
+    const int toCopy = std::min(ctx.numSamples, captureLength - (int)current.in.size());
+    if (toCopy > 0) {
+        current.in.insert(current.in.end(), ctx.inL, ctx.inL + toCopy);
+        current.out.insert(current.out.end(), ctx.outL, ctx.outL + toCopy);
+    }
+}
+
+void SweepDeconvolutionAnalyzer::finish(const juce::File& outDir) {
+    if (current.runId >= 0) {
+        processRun();
+        current.runId = -1;
+    }
+
+    if (responseFile) {
+        responseFile->close();
+        responseFile.reset();
+    }
+    if (irFile) {
+        irFile->close();
+        irFile.reset();
+    }
+}
+
+std::unique_ptr<Analyzer> createSweepDeconvolutionAnalyzer(const juce::File& outDir, double startHz, double endHz,
+                                                           double sweepSeconds,
+                                                           const std::vector<juce::String>& paramNames,
+                                                           const juce::String& signalType) {
+    return std::make_unique<SweepDeconvolutionAnalyzer>(outDir, startHz, endHz, sweepSeconds, paramNames, signalType);
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Analyzer.h"
+#include "JuceHeader.h"
+#include <complex>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <vector>
+
+// Farina exponential-sine-sweep analyzer.
+// Each run's input and output are deconvolved with the inverse of the configured log sweep (the
+// time-reversed sweep with a -6 dB/oct envelope) via one FFT convolution. The linear impulse response
+// lands at the sweep length, and the h-th harmonic response lands T * ln(h) / ln(f2 / f1) earlier, so a
+// single sweep run yields the linear frequency response and THD versus frequency.
+// Runs are processed as soon as the next run starts, so only one run's audio is held in memory.
+struct SweepDeconvolutionAnalyzer : public Analyzer {
+    static constexpr int maxHarmonic = 5;
+
+    SweepDeconvolutionAnalyzer(const juce::File& outDir, double startHz, double endHz, double sweepSeconds,
+                               const std::vector<juce::String>& paramNames, const juce::String& signalType);
+    ~SweepDeconvolutionAnalyzer() override;
+
+    void processBlock(const BlockContext& ctx) override;
+    void finish(const juce::File& outDir) override;
+
+private:
+    struct RunCapture {
+        int runId = -1;
+        std::vector<float> in;
+        std::vector<float> out;
+        std::map<juce::String, float> paramValues;
+        float inputGainDb = 0.0f;
+    };
+
+    RunCapture current;
+    double startHz;
+    double endHz;
+    double sweepSeconds;
+    std::vector<juce::String> paramNames;
+    juce::String signalType;
+
+    std::unique_ptr<std::ofstream> responseFile;
+    std::unique_ptr<std::ofstream> irFile;
+
+    // Inverse filter and FFT workspace, rebuilt whenever the sample rate changes
+    double preparedSampleRate = 0.0;
+    int sweepLength = 0;    // N, samples
+    int captureLength = 0;  // samples kept per run (sweep plus room for the response tail)
+    int irLength = 0;       // samples per extracted impulse response
+    int irPreSamples = 0;   // samples kept before each impulse peak
+    int numHarmonics = 0;
+    std::vector<int> harmonicOffsets; // index h: peak position of harmonic h in the deconvolved signal
+    std::unique_ptr<juce::dsp::FFT> convFft;
+    std::unique_ptr<juce::dsp::FFT> irFft;
+    std::vector<std::complex<float>> inverseSpectrum;
+    std::vector<float> convScratch;
+    std::vector<float> irWindow;
+
+    void prepare(double sampleRate);
+    void deconvolve(const std::vector<float>& signal, std::vector<float>& result);
+    void extractSpectrum(const std::vector<float>& deconvolved, int peak, std::vector<float>& ir,
+                         std::vector<std::complex<double>>& spectrum);
+    void processRun();
+    void writeParams(std::ostream& out, const RunCapture& run) const;
+};
+
+std::unique_ptr<Analyzer> createSweepDeconvolutionAnalyzer(const juce::File& outDir, double startHz, double endHz,
+                                                           double sweepSeconds,
+                                                           const std::vector<juce::String>& paramNames,
+                                                           const juce::String& signalType);
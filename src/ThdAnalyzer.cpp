@@ -5,100 +5,122 @@
 #include <fstream>
 #include <iostream>
 
-ThdAnalyzer::ThdAnalyzer(const juce::File& outDir, int fftSize, double fundamentalFreq,
+ThdAnalyzer::ThdAnalyzer(const juce::File& outDir, int windowSize, double fundamentalFreq,
                          const std::vector<juce::String>& paramNames, const juce::String& signalType)
-    : fftSize(fftSize), fundamentalFreq(fundamentalFreq), paramNames(paramNames), outputDir(outDir),
+    : targetWindowSize(windowSize), fundamentalFreq(fundamentalFreq), paramNames(paramNames), outputDir(outDir),
       signalType(signalType) {}
 
 ThdAnalyzer::~ThdAnalyzer() {}
 
-void ThdAnalyzer::applyHannWindow(std::vector<float>& buffer) {
-    const int N = (int)buffer.size();
-    for (int i = 0; i < N; ++i) {
-        float window = 0.5f * (1.0f - std::cos(2.0f * juce::MathConstants<float>::pi * (float)i / (float)(N - 1)));
-        buffer[i] *= window;
+void ThdAnalyzer::prepareBank(double sampleRate) {
+    bankSampleRate = sampleRate;
+
+    // Frequency-coherent window: an integer number of fundamental cycles near the target length
+    const double samplesPerCycle = sampleRate / fundamentalFreq;
+    const int cycles = std::max(1, (int)std::round((double)targetWindowSize / samplesPerCycle));
+    windowSize = std::max(4, (int)std::round((double)cycles * samplesPerCycle));
+
+    // Periodic Hann over the coherent span, in double so the window adds no error below a double-precision
+    // plugin's noise floor
+    window.resize(windowSize);
+    windowSum = 0.0;
+    for (int i = 0; i < windowSize; ++i) {
+        window[i] = 0.5 * (1.0 - std::cos(2.0 * juce::MathConstants<double>::pi * (double)i / (double)windowSize));
+        windowSum += window[i];
     }
-}
-
-double ThdAnalyzer::computeTHD(const std::vector<std::complex<float>>& fftResult, double sampleRate) {
-    const double binHz = sampleRate / (double)fftSize;
-    const int k0 = (int)std::round(fundamentalFreq / binHz);
-
-    if (k0 < 0 || k0 >= fftSize / 2)
-        return 0.0;
-
-    // Fundamental power
-    float fundamentalMag = std::abs(fftResult[k0]);
-    double P1 = (double)(fundamentalMag * fundamentalMag);
-
-    if (P1 <= 0.0)
-        return 0.0;
-
-    // Harmonic powers
-    double harmonicPowerSum = 0.0;
-    const int maxHarmonic = std::min(10, (fftSize / 2) / k0);
 
-    for (int h = 2; h <= maxHarmonic; ++h) {
-        int kh = h * k0;
-        if (kh >= fftSize / 2)
+    // Goertzel coefficients for every harmonic below Nyquist
+    numHarmonics = 0;
+    for (int h = 1; h <= maxHarmonic; ++h) {
+        const double freq = fundamentalFreq * (double)h;
+        if (freq >= 0.5 * sampleRate)
             break;
-
-        float harmonicMag = std::abs(fftResult[kh]);
-        double harmonicPower = (double)(harmonicMag * harmonicMag);
-        harmonicPowerSum += harmonicPower;
+        coeff[h] = 2.0 * std::cos(2.0 * juce::MathConstants<double>::pi * freq / sampleRate);
+        numHarmonics = h;
     }
-
-    // THD as ratio
-    double thd = std::sqrt(harmonicPowerSum / P1);
-    return thd;
 }
 
-void ThdAnalyzer::processFFTWindow(RunThdData& data, int64_t centreSample) {
-    if ((int)data.buffer.size() < fftSize)
-        return;
-
-    // Apply window
-    applyHannWindow(data.buffer);
+void ThdAnalyzer::finishWindow(RunThdData& data) {
+    ThdResult result;
+    result.centreSample = data.windowStart + windowSize / 2;
 
-    // Perform FFT
-    juce::dsp::FFT fft((int)std::log2(fftSize));
-    std::vector<std::complex<float>> fftResult(fftSize);
-
-    // Copy to complex buffer
-    for (int i = 0; i < fftSize; ++i) {
-        fftResult[i] = std::complex<float>(data.buffer[i], 0.0f);
+    // Sinusoid power from the Goertzel magnitude: A = 2|X| / sum(w), P = A^2 / 2
+    std::array<double, maxHarmonic + 1> power{};
+    for (int h = 1; h <= numHarmonics; ++h) {
+        const double magSq = data.s1[h] * data.s1[h] + data.s2[h] * data.s2[h] - coeff[h] * data.s1[h] * data.s2[h];
+        const double amplitude = 2.0 * std::sqrt(std::max(magSq, 0.0)) / windowSum;
+        power[h] = 0.5 * amplitude * amplitude;
     }
 
-    // Perform FFT (in-place)
-    fft.perform(fftResult.data(), fftResult.data(), false);
+    const double dc = data.sumWY / windowSum;
+    const double totalPower = std::max(data.sumWY2 / windowSum - dc * dc, 0.0);
+    const double P1 = power[1];
 
-    // Compute THD
-    double thd = computeTHD(fftResult, data.sampleRate);
-    data.thdResults.push_back({centreSample, thd});
+    double harmonicPowerSum = 0.0;
+    for (int h = 2; h <= numHarmonics; ++h)
+        harmonicPowerSum += power[h];
+
+    if (P1 > 0.0) {
+        result.thd = std::sqrt(harmonicPowerSum / P1);
+        result.thdN = std::sqrt(std::max(totalPower - P1, 0.0) / P1);
+        for (int h = 2; h <= numHarmonics; ++h)
+            result.harmonicDbc[h] = 10.0 * std::log10(std::max(power[h] / P1, 1e-20));
+    }
 
-    // Clear buffer for next window
-    data.buffer.clear();
+    result.fundamentalDb = 10.0 * std::log10(std::max(P1, 1e-20));
+    result.noiseDb = 10.0 * std::log10(std::max(totalPower - P1 - harmonicPowerSum, 1e-20));
+    data.thdResults.push_back(result);
+
+    // Reset the bank for the next window
+    data.s1.fill(0.0);
+    data.s2.fill(0.0);
+    data.sumWY = 0.0;
+    data.sumWY2 = 0.0;
+    data.windowPos = 0;
+    data.windowStart += windowSize;
 }
 
 void ThdAnalyzer::processBlock(const BlockContext& ctx) {
+    if (ctx.sampleRate != bankSampleRate)
+        prepareBank(ctx.sampleRate);
+
     auto& data = perRunData[ctx.runId];
 
     // Initialize on first block
-    if (data.buffer.empty()) {
+    if (!data.initialised) {
         data.paramValues = ctx.paramNamedValues;
         data.inputGainDb = ctx.inputGainDb;
         data.sampleRate = ctx.sampleRate;
+        data.numHarmonics = numHarmonics;
+        data.windowStart = ctx.firstSample;
+        data.initialised = true;
     }
 
-    // Accumulate samples
-    for (int i = 0; i < ctx.numSamples; ++i) {
-        data.buffer.push_back(ctx.outL[i]);
+    // Double-precision runs are analysed before the output is rounded to float
+    if (!ctx.outputsDouble.empty())
+        processSamples(data, ctx.outputsDouble[0], ctx.numSamples);
+    else
+        processSamples(data, ctx.outL, ctx.numSamples);
+}
+
+template <typename SampleType>
+void ThdAnalyzer::processSamples(RunThdData& data, const SampleType* out, int numSamples) {
+    for (int i = 0; i < numSamples; ++i) {
+        const double y = (double)out[i];
+        const double w = window[data.windowPos];
+        const double x = y * w;
 
-        // Process FFT window when we have enough samples
-        if ((int)data.buffer.size() >= fftSize) {
-            int64_t centreSample = ctx.firstSample + i - fftSize / 2;
-            processFFTWindow(data, centreSample);
+        data.sumWY += x;
+        data.sumWY2 += x * y;
+
+        for (int h = 1; h <= numHarmonics; ++h) {
+            const double s0 = x + coeff[h] * data.s1[h] - data.s2[h];
+            data.s2[h] = data.s1[h];
+            data.s1[h] = s0;
         }
+
+        if (++data.windowPos >= windowSize)
+            finishWindow(data);
     }
 }
 
@@ -113,7 +135,10 @@ void ThdAnalyzer::finish(const juce::File& outDir) {
     }
 
     // Header
-    out << "runId,centreSample,thd";
+    out << "runId,centreSample,thd,thdN,fundamentalDb,noiseDb";
+    for (int h = 2; h <= maxHarmonic; ++h) {
+        out << ",h" << h << "Dbc";
+    }
     for (const auto& paramName : paramNames) {
         out << "," << paramName.toStdString();
     }
@@ -121,8 +146,16 @@ void ThdAnalyzer::finish(const juce::File& outDir) {
 
     // Data rows
     for (const auto& [runId, data] : perRunData) {
-        for (const auto& [centreSample, thd] : data.thdResults) {
-            out << runId << "," << centreSample << "," << thd;
+        for (const auto& result : data.thdResults) {
+            out << runId << "," << result.centreSample << "," << result.thd << "," << result.thdN << ","
+                << result.fundamentalDb << "," << result.noiseDb;
+
+            // Harmonics at or above the run's Nyquist are left empty
+            for (int h = 2; h <= maxHarmonic; ++h) {
+                out << ",";
+                if (h <= data.numHarmonics)
+                    out << result.harmonicDbc[h];
+            }
 
             // Parameter values
             for (const auto& paramName : paramNames) {
@@ -138,8 +171,8 @@ void ThdAnalyzer::finish(const juce::File& outDir) {
     }
 }
 
-std::unique_ptr<Analyzer> createThdAnalyzer(const juce::File& outDir, int fftSize, double fundamentalFreq,
+std::unique_ptr<Analyzer> createThdAnalyzer(const juce::File& outDir, int windowSize, double fundamentalFreq,
                                             const std::vector<juce::String>& paramNames,
                                             const juce::String& signalType) {
-    return std::make_unique<ThdAnalyzer>(outDir, fftSize, fundamentalFreq, paramNames, signalType);
+    return std::make_unique<ThdAnalyzer>(outDir, windowSize, fundamentalFreq, paramNames, signalType);
 }
@@ -2,12 +2,18 @@
 
 #include "Analyzer.h"
 #include "JuceHeader.h"
-#include <complex>
+#include <array>
 #include <map>
 #include <vector>
 
+// Harmonic distortion analyzer built on a bank of Goertzel filters tuned exactly to the fundamental
+// and its harmonics. Windows span an integer number of fundamental cycles (close to the requested
+// window size) and are Hann-weighted, so leakage stays negligible even when the fundamental does not
+// fall on an FFT bin centre. Cost is O(numHarmonics) per sample instead of a full FFT per window.
 struct ThdAnalyzer : public Analyzer {
-    ThdAnalyzer(const juce::File& outDir, int fftSize, double fundamentalFreq,
+    static constexpr int maxHarmonic = 10;
+
+    ThdAnalyzer(const juce::File& outDir, int windowSize, double fundamentalFreq,
                 const std::vector<juce::String>& paramNames, const juce::String& signalType);
     ~ThdAnalyzer() override;
 
@@ -15,26 +21,53 @@ struct ThdAnalyzer : public Analyzer {
     void finish(const juce::File& outDir) override;
 
 private:
+    struct ThdResult {
+        int64_t centreSample = 0;
+        double thd = 0.0;           // sqrt(sum P_h, h >= 2) / sqrt(P_1)
+        double thdN = 0.0;          // sqrt(P_total - P_dc - P_1) / sqrt(P_1)
+        double fundamentalDb = 0.0; // fundamental RMS level, dBFS
+        double noiseDb = 0.0;       // residual after removing DC, fundamental and harmonics, dBFS
+        std::array<double, maxHarmonic + 1> harmonicDbc{}; // index h: level of harmonic h relative to P_1
+    };
+
     struct RunThdData {
-        std::vector<float> buffer;
-        std::vector<std::pair<int64_t, double>> thdResults; // (centreSample, thd)
+        // Goertzel state for harmonics 1..numHarmonics (index 0 unused)
+        std::array<double, maxHarmonic + 1> s1{};
+        std::array<double, maxHarmonic + 1> s2{};
+        double sumWY = 0.0;  // windowed sum, for DC
+        double sumWY2 = 0.0; // windowed power
+        int windowPos = 0;
+        int64_t windowStart = 0;
+        bool initialised = false;
+        std::vector<ThdResult> thdResults;
         std::map<juce::String, float> paramValues;
         float inputGainDb;
         double sampleRate = 48000.0;
+        int numHarmonics = 0; // harmonics below Nyquist at this run's sample rate
     };
 
     std::map<int, RunThdData> perRunData;
-    int fftSize;
+    int targetWindowSize;
     double fundamentalFreq;
     std::vector<juce::String> paramNames;
     juce::File outputDir;
     juce::String signalType;
 
-    void processFFTWindow(RunThdData& data, int64_t centreSample);
-    void applyHannWindow(std::vector<float>& buffer);
-    double computeTHD(const std::vector<std::complex<float>>& fftResult, double sampleRate);
+    // Filter bank, rebuilt whenever the sample rate changes
+    double bankSampleRate = 0.0;
+    int windowSize = 0;
+    int numHarmonics = 0;
+    double windowSum = 0.0;
+    std::vector<double> window;
+    std::array<double, maxHarmonic + 1> coeff{}; // 2 cos(w_h)
+
+    void prepareBank(double sampleRate);
+    void finishWindow(RunThdData& data);
+
+    template <typename SampleType>
+    void processSamples(RunThdData& data, const SampleType* out, int numSamples);
 };
 
-std::unique_ptr<Analyzer> createThdAnalyzer(const juce::File& outDir, int fftSize, double fundamentalFreq,
+std::unique_ptr<Analyzer> createThdAnalyzer(const juce::File& outDir, int windowSize, double fundamentalFreq,
                                             const std::vector<juce::String>& paramNames,
                                             const juce::String& signalType);
@@ -1,94 +1,173 @@
 #include "TransferCurveAnalyzer.h"
 #include <algorithm>
-#include <fstream>
 #include <iostream>
+#include <limits>
 
-TransferCurveAnalyzer::TransferCurveAnalyzer(const juce::File& outDir, int numBins,
+TransferCurveAnalyzer::TransferCurveAnalyzer(const juce::File& outDir, int numBins, bool includeRight,
                                              const std::vector<juce::String>& paramNames,
                                              const juce::String& signalType)
-    : numBins(numBins), paramNames(paramNames), outputDir(outDir), signalType(signalType) {}
-
-TransferCurveAnalyzer::~TransferCurveAnalyzer() {}
+    : numBins(std::max(1, numBins)), includeRight(includeRight), paramNames(paramNames), signalType(signalType) {
+    juce::String filename = "grid_transfer_curves_" + signalType.toLowerCase() + ".csv";
+    csvFile = std::make_unique<std::ofstream>(outDir.getChildFile(filename).getFullPathName().toStdString());
+    if (!csvFile->is_open()) {
+        std::cerr << "Failed to open " << filename.toStdString() << " for writing" << std::endl;
+        csvFile.reset();
+        return;
+    }
 
-int TransferCurveAnalyzer::getBinIndex(float x) const {
-    // Map x from [-1, 1] to [0, numBins-1]
-    float normalized = (x + 1.0f) * 0.5f; // [0, 1]
-    int bin = (int)(normalized * numBins);
-    return std::clamp(bin, 0, numBins - 1);
+    // Header
+    *csvFile << "runId,channel,direction,binIndex,x,meanY,varY,minY,maxY,count";
+    for (const auto& paramName : paramNames)
+        *csvFile << "," << paramName.toStdString();
+    *csvFile << ",inputGainDb\n";
 }
 
+TransferCurveAnalyzer::~TransferCurveAnalyzer() {}
+
 float TransferCurveAnalyzer::getBinCenter(int binIndex) const {
-    // Inverse of getBinIndex
+    // Inverse of the binning in accumulate()
     float normalized = ((float)binIndex + 0.5f) / (float)numBins; // [0, 1]
     return normalized * 2.0f - 1.0f;                              // [-1, 1]
 }
 
-void TransferCurveAnalyzer::processBlock(const BlockContext& ctx) {
-    auto& runData = perRunBins[ctx.runId];
+void TransferCurveAnalyzer::accumulate(int channel, const float* x, const float* y, int numSamples) {
+    if (numSamples <= 0)
+        return;
 
-    // Initialize bins on first block
-    if (runData.bins.empty()) {
-        runData.bins.resize(numBins);
-        runData.paramValues = ctx.paramNamedValues;
-        runData.inputGainDb = ctx.inputGainDb;
+    auto& run = current;
+    const int curveBase = channel * numDirections * numBins;
+    const float scale = 0.5f * (float)numBins;
+    const float maxPos = (float)(numBins - 1);
+
+    int bins[chunkSize];
+    for (int start = 0; start < numSamples; start += chunkSize) {
+        const int n = std::min(chunkSize, numSamples - start);
+        const float* xs = x + start;
+        const float* ys = y + start;
+
+        // Bin index ([-1, 1] -> [0, numBins - 1]) plus the falling-curve offset, branch-free so the loop
+        // vectorises; the first sample's slope is taken against the previous chunk, block or run start
+        const float prev = start > 0 ? x[start - 1] : (run.hasLastX[channel] ? run.lastX[channel] : xs[0]);
+        bins[0] = (int)std::clamp((xs[0] + 1.0f) * scale, 0.0f, maxPos) + (xs[0] < prev ? numBins : 0);
+        for (int i = 1; i < n; ++i)
+            bins[i] = (int)std::clamp((xs[i] + 1.0f) * scale, 0.0f, maxPos) + (xs[i] < xs[i - 1] ? numBins : 0);
+
+        for (int i = 0; i < n; ++i) {
+            const int index = curveBase + bins[i];
+            const float v = ys[i];
+            run.count[index]++;
+            run.sumY[index] += (double)v;
+            run.sumSqY[index] += (double)v * (double)v;
+            run.minY[index] = std::min(run.minY[index], v);
+            run.maxY[index] = std::max(run.maxY[index], v);
+        }
     }
 
-    // Accumulate input->output mapping
-    for (int i = 0; i < ctx.numSamples; ++i) {
-        float x = ctx.inL[i];
-        float y = ctx.outL[i];
+    run.lastX[channel] = x[numSamples - 1];
+    run.hasLastX[channel] = true;
+}
+
+void TransferCurveAnalyzer::processRun() {
+    if (!csvFile)
+        return;
 
-        int binIdx = getBinIndex(x);
-        runData.bins[binIdx].sumY += (double)y;
-        runData.bins[binIdx].count++;
+    auto& out = *csvFile;
+    static const char* const directionNames[] = {"all", "rising", "falling"};
+
+    for (int ch = 0; ch < current.numChannels; ++ch) {
+        const int rising = ch * numDirections * numBins;
+        const int falling = rising + numBins;
+
+        for (int direction = 0; direction < 3; ++direction) {
+            for (int bin = 0; bin < numBins; ++bin) {
+                // "all" merges the rising and falling statistics of the bin
+                int64_t count = 0;
+                double sumY = 0.0, sumSqY = 0.0;
+                float minY = std::numeric_limits<float>::max();
+                float maxY = std::numeric_limits<float>::lowest();
+                const int first = direction == 2 ? falling + bin : rising + bin;
+                const int last = direction == 1 ? rising + bin : falling + bin;
+                for (int index = first; index <= last; index += numBins) {
+                    count += current.count[index];
+                    sumY += current.sumY[index];
+                    sumSqY += current.sumSqY[index];
+                    minY = std::min(minY, current.minY[index]);
+                    maxY = std::max(maxY, current.maxY[index]);
+                }
+                if (count == 0)
+                    continue;
+
+                const double meanY = sumY / (double)count;
+                const double varY = std::max(0.0, sumSqY / (double)count - meanY * meanY);
+
+                out << current.runId << "," << current.channelNames[ch].toStdString() << ","
+                    << directionNames[direction] << "," << bin << "," << getBinCenter(bin) << "," << meanY << ","
+                    << varY << "," << minY << "," << maxY << "," << count;
+
+                // Parameter values
+                for (const auto& paramName : paramNames) {
+                    float value = 0.0f;
+                    auto it = current.paramValues.find(paramName);
+                    if (it != current.paramValues.end())
+                        value = it->second;
+                    out << "," << value;
+                }
+
+                out << "," << current.inputGainDb << "\n";
+            }
+        }
     }
 }
 
-void TransferCurveAnalyzer::finish(const juce::File& outDir) {
-    juce::String filename = "grid_transfer_curves_" + signalType.toLowerCase() + ".csv";
-    juce::File csvFile = outDir.getChildFile(filename);
-    std::ofstream out(csvFile.getFullPathName().toStdString());
-
-    if (!out.is_open()) {
-        std::cerr << "Failed to open " << filename.toStdString() << " for writing" << std::endl;
+void TransferCurveAnalyzer::beginBlock(const BlockContext& ctx) {
+    // A new run id means the previous run is complete
+    if (ctx.runId == current.runId)
         return;
-    }
 
-    // Header
-    out << "runId,binIndex,x,meanY,count";
-    for (const auto& paramName : paramNames) {
-        out << "," << paramName.toStdString();
+    if (current.runId >= 0)
+        processRun();
+
+    current.numChannels = includeRight ? std::max(1, std::min(ctx.inputs.numChannels, ctx.outputs.numChannels)) : 1;
+    current.channelNames.assign(ctx.outputs.names, ctx.outputs.names + current.numChannels);
+
+    const size_t size = (size_t)(current.numChannels * numDirections * numBins);
+    current.runId = ctx.runId;
+    current.count.assign(size, 0);
+    current.sumY.assign(size, 0.0);
+    current.sumSqY.assign(size, 0.0);
+    current.minY.assign(size, std::numeric_limits<float>::max());
+    current.maxY.assign(size, std::numeric_limits<float>::lowest());
+    current.lastX.assign(current.numChannels, 0.0f);
+    current.hasLastX.assign(current.numChannels, false);
+    current.paramValues = ctx.paramNamedValues;
+    current.inputGainDb = ctx.inputGainDb;
+}
+
+void TransferCurveAnalyzer::processSamples(const BlockContext& ctx, int start, int numSamples) {
+    for (int ch = 0; ch < current.numChannels; ++ch)
+        accumulate(ch, ctx.inputs[ch] + start, ctx.outputs[ch] + start, numSamples);
+}
+
+void TransferCurveAnalyzer::processBlock(const BlockContext& ctx) {
+    beginBlock(ctx);
+    processSamples(ctx, 0, ctx.numSamples);
+    endBlock(ctx);
+}
+
+void TransferCurveAnalyzer::finish(const juce::File& outDir) {
+    if (current.runId >= 0) {
+        processRun();
+        current.runId = -1;
     }
-    out << ",inputGainDb\n";
-
-    // Data rows
-    for (const auto& [runId, runData] : perRunBins) {
-        for (int binIdx = 0; binIdx < numBins; ++binIdx) {
-            const auto& bin = runData.bins[binIdx];
-            if (bin.count == 0)
-                continue;
-
-            float x = getBinCenter(binIdx);
-            double meanY = bin.sumY / bin.count;
-
-            out << runId << "," << binIdx << "," << x << "," << meanY << "," << bin.count;
-
-            // Parameter values
-            for (const auto& paramName : paramNames) {
-                float value = 0.0f;
-                auto it = runData.paramValues.find(paramName);
-                if (it != runData.paramValues.end())
-                    value = it->second;
-                out << "," << value;
-            }
 
-            out << "," << runData.inputGainDb << "\n";
-        }
+    if (csvFile) {
+        csvFile->close();
+        csvFile.reset();
     }
 }
 
-std::unique_ptr<Analyzer> createTransferCurveAnalyzer(const juce::File& outDir, int numBins,
+std::unique_ptr<Analyzer> createTransferCurveAnalyzer(const juce::File& outDir, int numBins, bool includeRight,
                                                       const std::vector<juce::String>& paramNames,
                                                       const juce::String& signalType) {
-    return std::make_unique<TransferCurveAnalyzer>(outDir, numBins, paramNames, signalType);
+    return std::make_unique<TransferCurveAnalyzer>(outDir, numBins, includeRight, paramNames, signalType);
 }
@@ -2,39 +2,63 @@
 
 #include "Analyzer.h"
 #include "JuceHeader.h"
+#include <fstream>
 #include <map>
+#include <memory>
 #include <vector>
 
+// Input->output transfer curve: output statistics (mean, variance, min, max) binned by input level over
+// [-1, 1]. Samples are split by input slope into rising and falling curves, so hysteresis (tape,
+// transformer and other stateful nonlinearities) shows up as the gap between them; the "all" curve merges
+// both. The front pair (inL -> outL) is always measured; with includeRight, so is every further pair of main
+// input and output channels (inR -> outR, then C, Lfe... on surround buses).
+// Bin statistics live in one flat structure-of-arrays per run, laid out [channel][direction][bin], and
+// are written out when the next run starts.
 struct TransferCurveAnalyzer : public Analyzer {
-    TransferCurveAnalyzer(const juce::File& outDir, int numBins, const std::vector<juce::String>& paramNames,
-                          const juce::String& signalType);
+    TransferCurveAnalyzer(const juce::File& outDir, int numBins, bool includeRight,
+                          const std::vector<juce::String>& paramNames, const juce::String& signalType);
     ~TransferCurveAnalyzer() override;
 
     void processBlock(const BlockContext& ctx) override;
     void finish(const juce::File& outDir) override;
 
+    // AnalyzerPipeline stage interface
+    void beginBlock(const BlockContext& ctx);
+    void processSamples(const BlockContext& ctx, int start, int numSamples);
+    void endBlock(const BlockContext& ctx) {}
+
 private:
-    struct BinData {
-        double sumY = 0.0;
-        int count = 0;
-    };
+    static constexpr int numDirections = 2; // rising, falling
+    static constexpr int chunkSize = 64;    // bin indices are computed a chunk at a time
 
-    struct RunBinData {
-        std::vector<BinData> bins;
+    struct RunBins {
+        int runId = -1;
+        std::vector<int64_t> count;
+        std::vector<double> sumY;
+        std::vector<double> sumSqY;
+        std::vector<float> minY;
+        std::vector<float> maxY;
+        int numChannels = 1;
+        std::vector<juce::String> channelNames; // "L", "R", "C"...
+        std::vector<float> lastX;               // previous input per channel, for the slope across blocks
+        std::vector<bool> hasLastX;
         std::map<juce::String, float> paramValues;
-        float inputGainDb;
+        float inputGainDb = 0.0f;
     };
 
-    std::map<int, RunBinData> perRunBins;
+    RunBins current;
     int numBins;
+    bool includeRight;
     std::vector<juce::String> paramNames;
-    juce::File outputDir;
     juce::String signalType;
 
-    int getBinIndex(float x) const;
+    std::unique_ptr<std::ofstream> csvFile;
+
     float getBinCenter(int binIndex) const;
+    void accumulate(int channel, const float* x, const float* y, int numSamples);
+    void processRun();
 };
 
-std::unique_ptr<Analyzer> createTransferCurveAnalyzer(const juce::File& outDir, int numBins,
+std::unique_ptr<Analyzer> createTransferCurveAnalyzer(const juce::File& outDir, int numBins, bool includeRight,
                                                       const std::vector<juce::String>& paramNames,
                                                       const juce::String& signalType);
@@ -1,6 +1,7 @@
 #include "Config.h"
 #include "JuceHeader.h"
 #include "MeasurementEngine.h"
+#include "ParameterScreening.h"
 #include "PluginLoader.h"
 #include <iostream>
 #include <vector>
@@ -83,8 +84,8 @@ int main(int argc, char* argv[]) {
         // Load plugin
         std::cout << "Loading plugin: " << config.pluginPath << std::endl;
         juce::String errorMessage;
-        auto plugin =
-            loadPluginInstance(juce::File(config.pluginPath), config.sampleRate, config.blockSize, errorMessage);
+        auto plugin = loadPluginInstance(juce::File(config.pluginPath), config.sampleRate, config.blockSize,
+                                         errorMessage, getBusLayoutRequest(config));
 
         if (plugin == nullptr) {
             std::cerr << (errorMessage.isEmpty() ? "Failed to load plugin" : errorMessage.toStdString()) << std::endl;
@@ -107,6 +108,12 @@ int main(int argc, char* argv[]) {
         }
         std::cout << "========================================\n" << std::endl;
 
+        // Screening pre-pass, which may fix inert parameters before the grid is built
+        if (config.screening) {
+            std::cout << "Screening parameters..." << std::endl;
+            config = runParameterScreening(*plugin, config, outDir);
+        }
+
         // Build parameter name list
         std::vector<juce::String> paramNames;
         for (const auto& bucket : config.parameterBuckets) {
@@ -115,7 +122,7 @@ int main(int argc, char* argv[]) {
 
         // Build run grid
         std::cout << "Building measurement grid..." << std::endl;
-        auto runs = buildRunGrid(config, paramNames);
+        auto runs = buildRunGrid(config, paramNames, plugin.get());
         std::cout << "Generated " << runs.size() << " measurement runs" << std::endl;
 
         // Create analyzers